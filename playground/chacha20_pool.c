@@ -0,0 +1,111 @@
+#include <stddef.h>
+#include <stdint.h>
+
+#include "chacha20_pool.h"
+
+extern void chacha20(uint8_t *out,
+                     const uint8_t *in,
+                     size_t inlen,
+                     const uint8_t *key,
+                     const uint8_t *nonce,
+                     uint32_t ctr);
+
+_Static_assert(sizeof(chacha20_session) == 128, "a session is two cache lines");
+
+static chacha20_session pool[CHACHA20_POOL_SESSIONS];
+static uint32_t free_head;            /* released sessions, index + 1 */
+static uint32_t fresh;                /* pool[fresh..] never handed out */
+static uint32_t in_use;
+
+chacha20_session *chacha20_session_acquire(const uint8_t *key, const uint8_t *nonce,
+                                           uint32_t ctr)
+{
+    chacha20_session *s;
+    if (free_head)                           s = &pool[free_head - 1u];
+    else if (fresh < CHACHA20_POOL_SESSIONS) s = &pool[fresh++];
+    else                                     return NULL;
+    free_head = s->next_free;
+
+    uint8_t *k = (uint8_t *)s->key, *n = (uint8_t *)s->nonce;
+    for (uint32_t i = 0; i < 32; i++) k[i] = key[i];
+    for (uint32_t i = 0; i < 12; i++) n[i] = nonce[i];
+    s->ctr       = ctr;
+    s->ks_pos    = 64;
+    s->next_free = 0;
+    s->in_use    = 1;
+    in_use++;
+    return s;
+}
+
+void chacha20_session_release(chacha20_session *s)
+{
+    if (!s->in_use) return;   /* double release would corrupt the free list */
+    for (uint32_t i = 0; i < 8; i++)  s->key[i] = 0;
+    for (uint32_t i = 0; i < 16; i++) s->ks[i] = 0;
+    s->in_use    = 0;
+    s->next_free = free_head;
+    free_head    = (uint32_t)(s - pool) + 1u;
+    in_use--;
+}
+
+uint32_t chacha20_pool_in_use(void)
+{
+    return in_use;
+}
+
+/* out[i] = in[i] ^ ks[pos + i]; word-wise while everything is aligned */
+static void xor_ks(uint8_t *out, const uint8_t *in, const uint32_t *ks,
+                   uint32_t pos, uint32_t n)
+{
+    const uint8_t *kb = (const uint8_t *)ks;
+    uint32_t i = 0;
+    if (((pos | (uintptr_t)out | (uintptr_t)in) & 3u) == 0) {
+        uint32_t *o = (uint32_t *)out;
+        const uint32_t *s = (const uint32_t *)in, *k = ks + (pos >> 2);
+        for (; i + 4u <= n; i += 4u) o[i >> 2] = s[i >> 2] ^ k[i >> 2];
+    }
+    for (; i < n; i++) out[i] = in[i] ^ kb[pos + i];
+}
+
+void chacha20_session_xor(chacha20_session *s, uint8_t *out, const uint8_t *in,
+                          size_t len)
+{
+    uint32_t pos = s->ks_pos, done = 0;
+
+    /* 1) keystream left over from the previous packet */
+    if (pos < 64u) {
+        done = (len < 64u - pos) ? (uint32_t)len : 64u - pos;
+        xor_ks(out, in, s->ks, pos, done);
+        pos += done;
+    }
+
+    /* 2) whole blocks straight from the state; the asm moves whole words,
+     * so only when both pointers are word-aligned */
+    uint32_t whole = ((uint32_t)len - done) & ~63u;
+    if (whole && (((uintptr_t)(out + done) | (uintptr_t)(in + done)) & 3u) == 0) {
+        chacha20(out + done, in + done, whole, (const uint8_t *)s->key,
+                 (const uint8_t *)s->nonce, s->ctr);
+        s->ctr += whole >> 6;
+        done   += whole;
+    }
+
+    /* 3) the rest block by block through s->ks; the last one keeps what it
+     * does not use */
+    while (done < len) {
+        uint32_t n = ((uint32_t)len - done < 64u) ? (uint32_t)len - done : 64u;
+        for (uint32_t i = 0; i < 16; i++) s->ks[i] = 0;
+        chacha20((uint8_t *)s->ks, (const uint8_t *)s->ks, 64, (const uint8_t *)s->key,
+                 (const uint8_t *)s->nonce, s->ctr);
+        s->ctr++;
+        xor_ks(out + done, in + done, s->ks, 0, n);
+        done += n;
+        pos   = n;
+    }
+    s->ks_pos = pos;
+}
+
+void chacha20_session_batch(const chacha20_packet *pkts, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+        chacha20_session_xor(pkts[i].s, pkts[i].out, pkts[i].in, pkts[i].len);
+}
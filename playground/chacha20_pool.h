@@ -0,0 +1,56 @@
+#ifndef CHACHA20_POOL_H
+#define CHACHA20_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* ---------------- ChaCha20 session pool ----------------
+ * A fixed array of CHACHA20_POOL_SESSIONS contexts, one per (key, nonce)
+ * stream. Acquire pops a free list (or takes the next never-used slot) and
+ * release pushes it back, both O(1); the pool needs no init.
+ *
+ * A session is two 64-byte cache lines: state words 4..15 (key, block
+ * counter, nonce) in block order plus bookkeeping, then the keystream left
+ * over from the last packet. Packets continue the stream byte by byte, so a
+ * session encrypts exactly as one chacha20() call over all its packets
+ * concatenated.
+ */
+#ifndef CHACHA20_POOL_SESSIONS
+#define CHACHA20_POOL_SESSIONS 256u
+#endif
+
+typedef struct {
+    uint32_t key[8];        /* state words 4..11 */
+    uint32_t ctr;           /* word 12: next block to generate */
+    uint32_t nonce[3];      /* words 13..15 */
+    uint32_t ks_pos;        /* bytes of ks already used, 64 = none left */
+    uint32_t next_free;     /* free list: pool index + 1, 0 ends it */
+    uint32_t in_use;
+    uint32_t pad;
+    uint32_t ks[16];        /* keystream of block ctr - 1 */
+} __attribute__((aligned(64))) chacha20_session;
+
+typedef struct {
+    chacha20_session *s;
+    uint8_t          *out;
+    const uint8_t    *in;
+    uint32_t          len;
+} chacha20_packet;
+
+/* NULL when every session is taken */
+chacha20_session *chacha20_session_acquire(const uint8_t *key, const uint8_t *nonce,
+                                           uint32_t ctr);
+
+/* Wipes key and keystream before the slot is reused */
+void chacha20_session_release(chacha20_session *s);
+
+/* out = in ^ the next len bytes of the session's keystream (out may be in) */
+void chacha20_session_xor(chacha20_session *s, uint8_t *out, const uint8_t *in,
+                          size_t len);
+
+/* One packet each for many sessions */
+void chacha20_session_batch(const chacha20_packet *pkts, uint32_t n);
+
+uint32_t chacha20_pool_in_use(void);
+
+#endif /* CHACHA20_POOL_H */
@@ -0,0 +1,115 @@
+#include <stddef.h>
+#include <stdint.h>
+
+#include "chacha20_prefetch.h"
+
+extern void chacha20(uint8_t *out,
+                     const uint8_t *in,
+                     size_t inlen,
+                     const uint8_t *key,
+                     const uint8_t *nonce,
+                     uint32_t ctr);
+
+#define K CHACHA20_PREFETCH_BLOCKS
+
+_Static_assert((K & (K - 1u)) == 0 && K != 0, "CHACHA20_PREFETCH_BLOCKS must be a power of two");
+
+/* Counters are compared without wrap-around: one (key, nonce) stream has at
+ * most 2^32 blocks (RFC 7539), so lo <= hi throughout. */
+
+void chacha20_prefetch_init(chacha20_prefetch *p, const uint8_t *key,
+                            const uint8_t *nonce, uint32_t ctr)
+{
+    uint8_t *k = (uint8_t *)p->key, *n = (uint8_t *)p->nonce;
+    for (uint32_t i = 0; i < 32; i++) k[i] = key[i];
+    for (uint32_t i = 0; i < 12; i++) n[i] = nonce[i];
+    p->lo = p->hi = ctr;
+    p->hit_blocks = p->miss_blocks = 0;
+}
+
+/* Keystream for n blocks from counter c: chacha20 over zeros, in place */
+static void keystream(const chacha20_prefetch *p, uint32_t *ks, uint32_t n, uint32_t c)
+{
+    for (uint32_t i = 0; i < (n << 4); i++) ks[i] = 0;
+    chacha20((uint8_t *)ks, (const uint8_t *)ks, n << 6,
+             (const uint8_t *)p->key, (const uint8_t *)p->nonce, c);
+}
+
+void chacha20_prefetch_fill(chacha20_prefetch *p)
+{
+    uint32_t end = p->lo + K;
+
+    /* At most two chacha20 calls: up to the end of the ring, then from 0 */
+    while (p->hi != end) {
+        uint32_t slot = p->hi & (K - 1u);
+        uint32_t n = end - p->hi;
+        if (n > K - slot) n = K - slot;
+        keystream(p, p->ks[slot], n, p->hi);
+        p->hi += n;
+    }
+}
+
+/* out = in ^ ks for len <= 64 bytes, word-wise when both pointers allow */
+static void xor_block(uint8_t *out, const uint8_t *in, const uint32_t *ks, uint32_t len)
+{
+    uint32_t i = 0;
+    if ((((uintptr_t)out | (uintptr_t)in) & 3u) == 0) {
+        uint32_t *o = (uint32_t *)out;
+        const uint32_t *s = (const uint32_t *)in;
+        for (; i + 4u <= len; i += 4u) o[i >> 2] = s[i >> 2] ^ ks[i >> 2];
+    }
+    const uint8_t *kb = (const uint8_t *)ks;
+    for (; i < len; i++) out[i] = in[i] ^ kb[i];
+}
+
+/* Blocks [c, e) of the request, computed now. Whole blocks go straight
+ * through chacha20 when out and in are word-aligned (it moves whole
+ * words); otherwise, and for a partial last block, each block is XORed from
+ * a local keystream block, so no byte past inlen is written. */
+static void xor_uncached(const chacha20_prefetch *p, uint8_t *out, const uint8_t *in,
+                         size_t inlen, uint32_t ctr, uint32_t c, uint32_t e)
+{
+    if (c == e) return;
+    uint32_t off = (c - ctr) << 6;
+    uint32_t len = ((e - ctr) << 6 > inlen) ? (uint32_t)inlen - off : (e - c) << 6;
+    uint32_t whole = len & ~63u;
+
+    if (whole && (((uintptr_t)(out + off) | (uintptr_t)(in + off)) & 3u) == 0)
+        chacha20(out + off, in + off, whole, (const uint8_t *)p->key,
+                 (const uint8_t *)p->nonce, c);
+    else
+        whole = 0;
+    for (uint32_t done = whole; done < len; done += 64u) {
+        uint32_t ks[16];
+        keystream(p, ks, 1, c + (done >> 6));
+        xor_block(out + off + done, in + off + done, ks,
+                  (len - done < 64u) ? len - done : 64u);
+    }
+}
+
+void chacha20_prefetch_xor(chacha20_prefetch *p, uint8_t *out, const uint8_t *in,
+                           size_t inlen, uint32_t ctr)
+{
+    uint32_t end = ctr + (uint32_t)((inlen + 63u) >> 6);
+
+    /* The request splits into a miss head [ctr, a), a cached run [a, b) and
+     * a miss tail [b, end); with no overlap everything is tail. */
+    uint32_t a = (ctr > p->lo) ? ctr : p->lo;
+    uint32_t b = (end < p->hi) ? end : p->hi;
+    if (a >= b) a = b = ctr;
+
+    xor_uncached(p, out, in, inlen, ctr, ctr, a);
+    for (uint32_t c = a; c != b; c++) {
+        uint32_t off = (c - ctr) << 6;
+        uint32_t len = (inlen - off < 64u) ? (uint32_t)inlen - off : 64u;
+        xor_block(out + off, in + off, p->ks[c & (K - 1u)], len);
+    }
+    xor_uncached(p, out, in, inlen, ctr, b, end);
+
+    p->hit_blocks  += b - a;
+    p->miss_blocks += (end - ctr) - (b - a);
+
+    /* Consume: blocks below end are never served again */
+    if (end > p->lo) p->lo = end;
+    if (p->hi < p->lo) p->hi = p->lo;
+}
@@ -0,0 +1,46 @@
+#ifndef CHACHA20_PREFETCH_H
+#define CHACHA20_PREFETCH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* ---------------- ChaCha20 keystream prefetch ----------------
+ * One cache per (key, nonce) stream. chacha20_prefetch_fill() computes the
+ * keystream blocks ahead of the stream position while the caller is idle;
+ * chacha20_prefetch_xor() is then a drop-in for chacha20() on that stream
+ * and only XORs for every block it finds cached.
+ *
+ * Blocks live in a ring indexed by counter & (K - 1) and are valid for
+ * counters [lo, hi), hi - lo <= K. A call covering blocks [ctr, ctr + n)
+ * consumes them: lo moves to ctr + n and never back, so a block is used at
+ * most once and a rewound or skipped counter falls back to chacha20() for
+ * the blocks outside [lo, hi). Changing key or nonce means a new init.
+ */
+#ifndef CHACHA20_PREFETCH_BLOCKS
+#define CHACHA20_PREFETCH_BLOCKS 4u   /* K, a power of two */
+#endif
+
+typedef struct {
+    uint32_t key[8];        /* word copies: chacha20 loads them with lw */
+    uint32_t nonce[3];
+    uint32_t lo, hi;        /* cached counters */
+    uint32_t hit_blocks;    /* blocks served from the cache */
+    uint32_t miss_blocks;   /* blocks computed inside chacha20_prefetch_xor */
+    uint32_t ks[CHACHA20_PREFETCH_BLOCKS][16];
+} chacha20_prefetch;
+
+/* Start a stream at block counter ctr; nothing is computed yet */
+void chacha20_prefetch_init(chacha20_prefetch *p, const uint8_t *key,
+                            const uint8_t *nonce, uint32_t ctr);
+
+/* Idle-time work: top the cache up to K blocks from lo */
+void chacha20_prefetch_fill(chacha20_prefetch *p);
+
+/* Same result as chacha20(out, in, inlen, key, nonce, ctr); unlike
+ * chacha20 it writes exactly inlen bytes and takes out/in at any byte
+ * offset. */
+void chacha20_prefetch_xor(chacha20_prefetch *p, uint8_t *out, const uint8_t *in,
+                           size_t inlen, uint32_t ctr);
+
+#endif /* CHACHA20_PREFETCH_H */
@@ -0,0 +1,22 @@
+#ifndef COMMON_H
+#define COMMON_H
+
+#include <stdint.h>
+
+/* ---------------- Shared constants and helpers ----------------
+ * Used by main.c and the C kernels; header-only so every object keeps its
+ * own inlined copy. */
+#define UF8_MAX 1015792u   /* uf8_decode(0xFF), the largest uf8 value */
+
+/* Marsaglia xorshift32: advance *s (nonzero) and return the new state.
+ * Deterministic test data and sensor noise; not for keys. */
+static inline uint32_t xorshift32(uint32_t *s)
+{
+    uint32_t x = *s;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *s = x;
+}
+
+#endif /* COMMON_H */
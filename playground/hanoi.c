@@ -0,0 +1,82 @@
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "hanoi.h"
+
+/* (p + d) mod 3 for p in 0..2, d in 1..2 */
+static inline uint32_t peg_add(uint32_t p, uint32_t d)
+{
+    p += d;
+    return (p >= 3u) ? p - 3u : p;
+}
+
+bool hanoi_resume_init(hanoi_iter *it, uint32_t *pos, uint32_t ndisks,
+                       uint32_t target)
+{
+    if (ndisks > HANOI_MAX_DISKS || target > 2u) return false;
+
+    /* Largest disk first: a disk already on its goal passes the goal down;
+     * otherwise everything smaller must first gather on the third peg. */
+    uint32_t goal = target, moves = 0;
+    for (uint32_t d = ndisks; d-- > 0;) {
+        uint32_t p = pos[d];
+        if (p > 2u) return false;
+        it->goal[d] = (uint8_t)goal;
+        if (p != goal) {
+            moves += 1u << d;          /* the pivot move + (2^d - 1) tower moves */
+            goal = 3u - p - goal;
+        }
+    }
+
+    it->pos        = pos;
+    it->ndisks     = ndisks;
+    it->moves      = moves;
+    it->next_pivot = 0;
+    it->step       = 0;
+    it->steps      = 0;
+    it->small_dir  = 1;
+    return true;
+}
+
+bool hanoi_resume_next(hanoi_iter *it, hanoi_move *mv)
+{
+    uint32_t *pos = it->pos;
+
+    if (it->step < it->steps) {
+        /* Tower phase: Gray(n) ^ Gray(n-1) is the lowest set bit of n */
+        uint32_t n = ++it->step;
+        uint32_t d = 0;
+        while (!(n & 1u)) { n >>= 1; d++; }
+
+        uint32_t from = pos[d], to;
+        if (d == 0)
+            to = peg_add(from, it->small_dir);   /* smallest disk cycles */
+        else
+            to = 3u - from - pos[0];             /* only move not onto disk 0 */
+        pos[d] = to;
+        mv->disk = d;
+        mv->from = from;
+        mv->to   = to;
+        return true;
+    }
+
+    /* Next pivot: the smaller disks all sit on its spare peg by now */
+    uint32_t k = it->next_pivot;
+    while (k < it->ndisks && pos[k] == it->goal[k]) k++;
+    if (k >= it->ndisks) return false;
+
+    uint32_t from = pos[k], to = it->goal[k];
+    uint32_t spare = 3u - from - to;
+    pos[k] = to;
+    mv->disk = k;
+    mv->from = from;
+    mv->to   = to;
+
+    /* Tower of k disks spare -> to: with k odd the smallest disk steps
+     * straight towards the destination, with k even via the other peg. */
+    it->next_pivot = k + 1u;
+    it->step       = 0;
+    it->steps      = (1u << k) - 1u;
+    it->small_dir  = (k & 1u) ? peg_add(to, 3u - spare) : peg_add(from, 3u - spare);
+    return true;
+}
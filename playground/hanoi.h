@@ -0,0 +1,44 @@
+#ifndef HANOI_H
+#define HANOI_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* ---------------- Tower of Hanoi from an arbitrary configuration ----------------
+ * Same state as test_Hanoi: pos[d] is the peg (0..2) of disk d, disk 0 the
+ * smallest. Any pos[] is a legal configuration (each peg holds its disks in
+ * size order), so the solver accepts every assignment of pegs.
+ *
+ * The optimal solution to a target peg moves, for every "pivot" disk k that
+ * is not where it must end up (largest first decides the goals, smallest
+ * first executes):
+ *   disk k to its goal, then the k smaller disks as one tower from the spare
+ *   peg onto it (2^k - 1 moves, Gray-code order as in test_Hanoi).
+ * The iterator produces one move per call in O(1) amortized time and keeps
+ * O(N) state; pos[] is updated as it goes.
+ */
+#define HANOI_MAX_DISKS 31u   /* optimal move count stays below 2^31 */
+
+typedef struct {
+    uint32_t disk, from, to;
+} hanoi_move;
+
+typedef struct {
+    uint32_t *pos;
+    uint32_t  ndisks;
+    uint32_t  moves;          /* optimal move count, set by init */
+    uint32_t  next_pivot;     /* lowest disk not yet checked as a pivot */
+    uint32_t  step, steps;    /* Gray-code counter of the current tower */
+    uint32_t  small_dir;      /* disk 0 peg increment (1 or 2) in that tower */
+    uint8_t   goal[HANOI_MAX_DISKS];
+} hanoi_iter;
+
+/* Plan the solution to peg target; false if ndisks, target or a pos[] entry
+ * is out of range. */
+bool hanoi_resume_init(hanoi_iter *it, uint32_t *pos, uint32_t ndisks,
+                       uint32_t target);
+
+/* Next optimal move (already applied to pos[]); false when solved */
+bool hanoi_resume_next(hanoi_iter *it, hanoi_move *mv);
+
+#endif /* HANOI_H */
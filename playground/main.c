@@ -2,6 +2,18 @@
 #include <stdint.h>
 #include <stddef.h>   // for size_t
 
+#include "chacha20_pool.h"
+#include "common.h"
+#include "chacha20_prefetch.h"
+#include "hanoi.h"
+#include "perfregion.h"
+#include "pipeline.h"
+#include "q16dsp.h"
+#include "qfmt.h"
+#include "rsqrt_cache.h"
+#include "tracelog.h"
+#include "uf8conv.h"
+
 #define printstr(ptr, length)                   \
     do {                                        \
         asm volatile(                           \
@@ -138,21 +150,34 @@ static inline void print_str(const char *s) {
     printstr(s, (unsigned long)(p - s));
 }
 
-/* Print a Q16 fixed-point value as "int.frac" with given digits (integer-only) */
+/* Print a Q16 fixed-point value as "int.frac" with given digits (at most
+ * 16), correctly rounded, in one write */
 static void print_q16_u(uint32_t y_q16, int frac_digits)
 {
-    print_dec_inline(y_q16 >> 16);
-    if (frac_digits <= 0) { print_ch('\n'); return; }
+    char buf[QFMT_MAX_LEN(16) + 1];
+    uint32_t digits = frac_digits <= 0 ? 0u : frac_digits > 16 ? 16u : (uint32_t)frac_digits;
+    uint32_t len = qfmt_u32(buf, y_q16, 16, digits);
+    buf[len++] = '\n';
+    printstr(buf, len);
+}
 
+/* num/den with two decimals */
+static void print_ratio(uint32_t num, uint32_t den)
+{
+    uint32_t q = udiv(num, den);
+    uint32_t r = udiv(umul(num - umul(q, den), 100), den);
+    print_dec_inline(q);
     print_ch('.');
-    uint32_t frac = y_q16 & 0xFFFFu;
-    for (int i = 0; i < frac_digits; i++) {
-        uint32_t frac10 = (frac << 3) + (frac << 1);  /* *10 in Q16 */
-        uint32_t digit  = frac10 >> 16;               /* integer part */
-        frac            = frac10 & 0xFFFFu;           /* remainder */
-        print_ch((char)('0' + digit));
-    }
-    print_ch('\n');
+    if (r < 10) print_ch('0');
+    print_dec(r);
+}
+
+/* Common bench tail: the mismatch count, then PASSED only if it is 0 */
+static void report_mismatches(uint32_t bad)
+{
+    TEST_LOGGER("  mismatches="); print_dec(bad);
+    if (bad == 0) TEST_LOGGER("  PASSED\n");
+    else          TEST_LOGGER("  FAILED\n");
 }
 
 /* ---------------- External test targets ---------------- */
@@ -162,58 +187,188 @@ extern void chacha20(uint8_t *out,
                      const uint8_t *key,
                      const uint8_t *nonce,
                      uint32_t ctr);
+extern const uint32_t chacha20_rolled, chacha20_code_bytes;
 
 typedef uint8_t uf8;
 extern uint32_t uf8_decode(uf8 fl);
 extern uf8      uf8_encode(uint32_t value);
+extern uint32_t clz_branchless(uint32_t x);
+
 
 extern uint32_t fast_rsqrt(uint32_t x);
 
-/* ---------------- Tests ---------------- */
-static void test_UF8(void)
+/* ---------------- Tests ----------------
+ * With trace_fd >= 0 (--trace=FD) the per-value lines of test_UF8 and
+ * test_Fast_rsqrt become UF8_DATA / RSQRT trace records on that fd instead
+ * of being formatted in the guest; verdicts stay text. */
+static void test_UF8(uint32_t count, int trace_fd)
 {
     int32_t previous_value = -1;
 
-    for (int i = 0; i < 8; i++) {
-        TEST_LOGGER("  Data: ");
-        print_dec((unsigned long)i);
+    if (trace_fd >= 0) trace_init(trace_fd);
+    for (uint32_t i = 0; i < count; i++) {
+        if (trace_fd >= 0) {
+            TRACE1(UF8_DATA, i);
+        } else {
+            TEST_LOGGER("  Data: ");
+            print_dec((unsigned long)i);
+        }
 
+        PERF_REGION_BEGIN("uf8_roundtrip");
         uint8_t  fl    = (uint8_t)i;
         int32_t  value = (int32_t)uf8_decode(fl);
         uint8_t  fl2   = uf8_encode((uint32_t)value);
+        PERF_REGION_END();
 
-        if (fl != fl2) {
-            TEST_LOGGER("  Mismatch!\n");
-            return;
-        }
-        if (value <= previous_value) {
+        if (fl != fl2 || value <= previous_value) {
+            if (trace_fd >= 0) trace_flush();
             TEST_LOGGER("  Mismatch!\n");
             return;
         }
         previous_value = value;
     }
+    if (trace_fd >= 0) trace_flush();
     TEST_LOGGER("  PASSED\n");
 }
 
 extern void test_Hanoi(void);
 
-void test_Fast_rsqrt(void)
+/* Per-peg bitboards (bit d set = disk d on the peg) for checking moves */
+static bool hanoi_apply_move(uint32_t pegs[3], const hanoi_move *mv)
+{
+    uint32_t bit = 1u << mv->disk, smaller = bit - 1u;
+    if (!(pegs[mv->from] & bit) || (pegs[mv->from] & smaller) || (pegs[mv->to] & smaller))
+        return false;
+    pegs[mv->from] &= ~bit;
+    pegs[mv->to]   |= bit;
+    return true;
+}
+
+/* Solve pos[] to target, printing each move; false on an illegal move,
+ * a count different from the planned optimum or an unsolved end state. */
+static bool hanoi_resume_checked(uint32_t *pos, uint32_t n, uint32_t target)
+{
+    static const char pegs_ch[3] = {'A', 'B', 'C'};
+    uint32_t pegs[3] = {0, 0, 0};
+    uint32_t count = 0;
+    hanoi_iter it;
+    hanoi_move mv;
+
+    for (uint32_t d = 0; d < n; d++) pegs[pos[d]] |= 1u << d;
+    if (!hanoi_resume_init(&it, pos, n, target)) return false;
+    while (hanoi_resume_next(&it, &mv)) {
+        if (!hanoi_apply_move(pegs, &mv)) return false;
+        TEST_LOGGER("Move Disk ");
+        print_dec_inline(mv.disk + 1);
+        TEST_LOGGER(" from ");  print_ch(pegs_ch[mv.from]);
+        TEST_LOGGER(" to ");    print_ch(pegs_ch[mv.to]);
+        print_ch('\n');
+        count++;
+    }
+    TEST_LOGGER("  moves=");
+    print_dec(count);
+    return count == it.moves && pegs[target] == (1u << n) - 1u;
+}
+
+/* Mid-game states; the first case is test_Hanoi's start and must replay it */
+static void test_Hanoi_resume(void)
+{
+    static const struct {
+        uint32_t n, target;
+        uint32_t pos[5];
+    } cases[] = {
+        {3, 2, {0, 0, 0}},
+        {4, 2, {1, 0, 2, 0}},
+        {5, 1, {2, 2, 0, 1, 0}},
+        {4, 0, {0, 0, 0, 0}},       /* already solved */
+    };
+    for (unsigned i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        uint32_t pos[5];
+        for (uint32_t d = 0; d < cases[i].n; d++) pos[d] = cases[i].pos[d];
+
+        TEST_LOGGER("\nResume ");
+        print_dec_inline(cases[i].n);
+        TEST_LOGGER(" disks -> ");
+        print_ch((char)('A' + cases[i].target));
+        print_ch('\n');
+        if (hanoi_resume_checked(pos, cases[i].n, cases[i].target))
+            TEST_LOGGER("  PASSED\n");
+        else
+            TEST_LOGGER("  FAILED\n");
+    }
+}
+
+/* Solve a pseudo-random n-disk configuration to peg C without printing */
+#define HANOI_BENCH_MAX_DISKS 24u
+
+static void hanoi_random_pos(uint32_t *pos, uint32_t n)
+{
+    uint32_t s = 0x9E3779B9u;
+    for (uint32_t d = 0; d < n; d++) {
+        xorshift32(&s);
+        pos[d] = umod(s, 3);
+    }
+}
+
+static void bench_Hanoi_resume(uint32_t n)
+{
+    uint32_t pos[HANOI_BENCH_MAX_DISKS];
+    uint32_t count = 0;
+    hanoi_iter it;
+    hanoi_move mv;
+
+    if (n > HANOI_BENCH_MAX_DISKS) n = HANOI_BENCH_MAX_DISKS;
+    hanoi_random_pos(pos, n);
+
+    uint32_t t0 = (uint32_t)get_cycles();
+    hanoi_resume_init(&it, pos, n, 2);
+    while (hanoi_resume_next(&it, &mv)) count++;
+    uint32_t cycles = (uint32_t)get_cycles() - t0;
+
+    TEST_LOGGER("  disks=");        print_dec_inline(n);
+    TEST_LOGGER("  moves=");        print_dec_inline(count);
+    TEST_LOGGER("  cycles=");       print_dec(cycles);
+    TEST_LOGGER("  cycles/move=");  print_ratio(cycles, count ? count : 1);
+    TEST_LOGGER("  moves/kcycle="); print_ratio(count, cycles >= 1000 ? udiv(cycles, 1000) : 1);
+}
+
+void test_Fast_rsqrt(int trace_fd)
 {
     static const uint32_t tests[] = {
         1, 2, 4, 5, 10, 16, 20, 100, 1000, 0xFFFFFFFFu
     };
+    if (trace_fd >= 0) trace_init(trace_fd);
     for (unsigned i = 0; i < sizeof(tests)/sizeof(tests[0]); i++) {
         uint32_t x  = tests[i];
+        PERF_REGION_BEGIN("fast_rsqrt");
         uint32_t yq = fast_rsqrt(x);  /* y ≈ 2^16 / sqrt(x) */
+        PERF_REGION_END();
 
-        print_str("x=");
-        print_dec_inline(x);
-        print_str("  fast_rsqrt≈");
-        print_q16_u(yq, 4);           /* show 4 fractional digits */
+        PERF_REGION_BEGIN("print");
+        if (trace_fd >= 0) {
+            TRACE2(RSQRT, x, yq);
+        } else {
+            print_str("x=");
+            print_dec_inline(x);
+            print_str("  fast_rsqrt≈");
+            print_q16_u(yq, 4);           /* show 4 fractional digits */
+        }
+        PERF_REGION_END();
     }
+    if (trace_fd >= 0) trace_flush();
+}
+
+/* Sweep x = 1..n through fast_rsqrt without printing each value */
+static void bench_Fast_rsqrt(uint32_t n)
+{
+    uint32_t sum = 0;
+    for (uint32_t x = 1; x <= n && x != 0; x++)
+        sum += fast_rsqrt(x);
+    TEST_LOGGER("  checksum=");
+    print_hex(sum);
 }
 
-/* RFC 7539 §2.4.2 test (kept for reference; not invoked by main) */
+/* RFC 7539 §2.4.2 test (default input set for --kernel=chacha20) */
 static void test_chacha20(void)
 {
     const uint8_t key[32] = {
@@ -242,7 +397,9 @@ static void test_chacha20(void)
     };
 
     TEST_LOGGER("Test: ChaCha20\n");
+    PERF_REGION_BEGIN("chacha20");
     chacha20(out, in, sizeof(in), key, nonce, ctr);
+    PERF_REGION_END();
 
     bool passed = true;
     for (size_t i = 0; i < sizeof(exp); i++) {
@@ -255,50 +412,1391 @@ static void test_chacha20(void)
     }
 }
 
-/* ---------------- Main ---------------- */
-int main(void)
+/* Encrypt n bytes in place; the buffer is shared by every --size run */
+#define CHACHA20_BENCH_MAX 65536u
+static uint8_t chacha20_buf[CHACHA20_BENCH_MAX] __attribute__((aligned(4)));
+
+static void bench_chacha20(uint32_t n)
+{
+    static const uint8_t key[32]   = {1, 2, 3, 4, 5, 6, 7, 8};
+    static const uint8_t nonce[12] = {0, 0, 0, 0, 0, 0, 0, 74};
+
+    chacha20(chacha20_buf, chacha20_buf, n, key, nonce, 1);
+    TEST_LOGGER("  bytes=");     print_dec_inline(n);
+    TEST_LOGGER("  out[0..3]="); print_hex(*(const uint32_t *)chacha20_buf);
+}
+
+/* ---------------- uf8 / Q16 / float32 converters ---------------- */
+#define CONV_MAX 1024u
+static uint8_t  conv_codes[CONV_MAX], conv_back[CONV_MAX];
+static uint32_t conv_a[CONV_MAX], conv_b[CONV_MAX];
+
+/* Composed path the converters replace: integer <-> float32 bits by
+ * normalizing with clz, around uf8_decode/uf8_encode (v < 2^24) */
+static uint32_t u32_to_f32_bits(uint32_t v)
+{
+    if (v == 0) return 0;
+    uint32_t msb = 31u - clz_branchless(v);
+    return ((126u + msb) << 23) + (v << (23u - msb));
+}
+
+static uint32_t f32_bits_to_u32(uint32_t b)
+{
+    uint32_t be = (b >> 23) & 0xFFu;
+    if ((b >> 31) || be < 127u) return 0;
+    return ((b & 0x007FFFFFu) | 0x00800000u) >> (150u - be);
+}
+
+static void conv_report(const char *name, uint32_t cycles, uint32_t n)
+{
+    print_str(name);
+    TEST_LOGGER(" cycles=");       print_dec_inline(cycles);
+    TEST_LOGGER("  cycles/elem="); print_ratio(cycles, n);
+}
+
+#define CONV_TIME(name, n, stmt)                                \
+    do {                                                        \
+        uint32_t _t0 = (uint32_t)get_cycles();                  \
+        stmt;                                                   \
+        conv_report(name, (uint32_t)get_cycles() - _t0, n);     \
+    } while (0)
+
+static void bench_conv(uint32_t n)
+{
+    uint32_t bad = 0, s = 0x2545F491u;
+
+    for (uint32_t i = 0; i < n; i++) conv_codes[i] = (uint8_t)i;
+
+    /* Cycles: batch converter, then the composed per-element path */
+    TEST_LOGGER("  cycles (batch vs composed):\n");
+    CONV_TIME("  uf8->Q16          ", n, uf8_to_q16(conv_a, conv_codes, n, 4));
+    CONV_TIME("  uf8->Q16 composed ", n,
+              for (uint32_t i = 0; i < n; i++) conv_b[i] = uf8_decode(conv_codes[i]) << 12);
+    for (uint32_t i = 0; i < n; i++) bad += conv_a[i] != conv_b[i];
+
+    CONV_TIME("  Q16->uf8          ", n, q16_to_uf8(conv_back, conv_a, n, 4));
+    CONV_TIME("  Q16->uf8 composed ", n,
+              for (uint32_t i = 0; i < n; i++) conv_back[i] = uf8_encode(conv_a[i] >> 12));
+    CONV_TIME("  uf8->f32          ", n, uf8_to_f32(conv_a, conv_codes, n));
+    CONV_TIME("  uf8->f32 composed ", n,
+              for (uint32_t i = 0; i < n; i++)
+                  conv_b[i] = u32_to_f32_bits(uf8_decode(conv_codes[i])));
+    for (uint32_t i = 0; i < n; i++) bad += conv_a[i] != conv_b[i];
+
+    CONV_TIME("  f32->uf8          ", n, f32_to_uf8(conv_back, conv_a, n));
+    CONV_TIME("  f32->uf8 composed ", n,
+              for (uint32_t i = 0; i < n; i++)
+                  conv_back[i] = uf8_encode(f32_bits_to_u32(conv_a[i])));
+    CONV_TIME("  Q16->f32          ", n, q16_to_f32(conv_b, conv_a, n));
+    CONV_TIME("  f32->Q16          ", n, f32_to_q16(conv_a, conv_b, n));
+
+    /* Errors: uf8 round trips are exact for scale <= 16, Q16 -> f32 rounds
+     * only above 2^24 raw, Q16 -> uf8 quantizes to at most 1/16 of the value. */
+    for (uint32_t scale = 4; scale <= 16; scale += 12) {
+        uf8_to_q16(conv_a, conv_codes, n, scale);
+        q16_to_uf8(conv_back, conv_a, n, scale);
+        for (uint32_t i = 0; i < n; i++) bad += conv_back[i] != conv_codes[i];
+    }
+    bad += uf8_to_q16(conv_a, conv_codes, n, UF8CONV_SCALE_MIN - 1u);
+    bad += q16_to_uf8(conv_back, conv_a, n, UF8CONV_SCALE_MAX + 1u);
+    uf8_to_f32(conv_a, conv_codes, n);
+    f32_to_uf8(conv_back, conv_a, n);
+    for (uint32_t i = 0; i < n; i++) bad += conv_back[i] != conv_codes[i];
+    TEST_LOGGER("  uf8 round-trip mismatches="); print_dec(bad);
+
+    uint32_t max_abs = 0, max_bp = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        xorshift32(&s);
+        conv_a[i] = s >> (s & 31u);
+    }
+    q16_to_f32(conv_b, conv_a, n);
+    f32_to_q16(conv_b, conv_b, n);
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t d = conv_a[i] > conv_b[i] ? conv_a[i] - conv_b[i] : conv_b[i] - conv_a[i];
+        if (d > max_abs) max_abs = d;
+    }
+    TEST_LOGGER("  Q16->f32->Q16 max |error| (raw)="); print_dec(max_abs);
+
+    for (uint32_t i = 0; i < n; i++) conv_a[i] = umod(conv_a[i], UF8_MAX + 1u);
+    q16_to_uf8(conv_back, conv_a, n, 16);
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t v = conv_a[i], d = v - uf8_decode(conv_back[i]);
+        uint32_t bp = v ? udiv(umul(d, 10000), v) : 0;   /* basis points */
+        if (bp > max_bp) max_bp = bp;
+    }
+    TEST_LOGGER("  Q16->uf8 max rel error %="); print_ratio(max_bp, 100);
+
+    if (bad == 0 && max_bp <= 625) TEST_LOGGER("  PASSED\n");
+    else                           TEST_LOGGER("  FAILED\n");
+}
+
+/* ---------------- Q16 FIR / dot product ---------------- */
+#define FIR_MAX_OUT 256u
+static q16_fir fir_filter;
+static int32_t fir_coeffs[Q16_FIR_MAX_TAPS];
+static int32_t fir_x[FIR_MAX_OUT + Q16_FIR_MAX_TAPS];
+static int32_t fir_y[FIR_MAX_OUT], fir_y_ref[FIR_MAX_OUT];
+
+/* Naive composed tap: signed 32x32 -> 64 product from four 16x16 umul
+ * (__mulsi3) partial products, as quiz3 composes its Q16 products */
+static int64_t mul_s32_umul(int32_t a, int32_t b)
+{
+    uint32_t ua = (a < 0) ? 0u - (uint32_t)a : (uint32_t)a;
+    uint32_t ub = (b < 0) ? 0u - (uint32_t)b : (uint32_t)b;
+    uint32_t a_lo = ua & 0xFFFFu, a_hi = ua >> 16;
+    uint32_t b_lo = ub & 0xFFFFu, b_hi = ub >> 16;
+    uint64_t acc = 0;
+    acc += ((uint64_t)umul(a_hi, b_hi)) << 32;
+    acc += ((uint64_t)umul(a_lo, b_hi)) << 16;
+    acc += ((uint64_t)umul(a_hi, b_lo)) << 16;
+    acc += (uint64_t)umul(a_lo, b_lo);
+    return ((a < 0) != (b < 0)) ? -(int64_t)acc : (int64_t)acc;
+}
+
+static void fir_naive(int32_t *y, const int32_t *x, uint32_t ntaps, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        int64_t acc = 0;
+        for (uint32_t k = 0; k < ntaps; k++)
+            acc += mul_s32_umul(fir_coeffs[k], x[i + ntaps - 1u - k]);
+        acc >>= 16;
+        y[i] = (acc > INT32_MAX) ? INT32_MAX : (acc < INT32_MIN) ? INT32_MIN : (int32_t)acc;
+    }
+}
+
+/* n outputs per tap count; 4/8/16 use the unrolled kernels, 12 the generic one */
+static void bench_fir(uint32_t n)
+{
+    static const uint32_t tap_counts[] = {4, 8, 12, 16};
+    uint32_t s = 0x2545F491u, bad = 0;
+
+    for (uint32_t i = 0; i < n + Q16_FIR_MAX_TAPS; i++) {
+        xorshift32(&s);
+        fir_x[i] = (int32_t)s >> (s & 15u);       /* Q16 samples, mixed magnitudes */
+    }
+
+    for (unsigned c = 0; c < sizeof(tap_counts) / sizeof(tap_counts[0]); c++) {
+        uint32_t taps = tap_counts[c], t0, fast, naive;
+
+        for (uint32_t k = 0; k < taps; k++) {
+            xorshift32(&s);
+            fir_coeffs[k] = (int32_t)(s & 0xFFFFu) - 32768;   /* [-0.5, 0.5) */
+        }
+        q16_fir_init(&fir_filter, fir_coeffs, taps);
+
+        t0 = (uint32_t)get_cycles();
+        q16_fir_run(&fir_filter, fir_y, fir_x, n);
+        fast = (uint32_t)get_cycles() - t0;
+
+        t0 = (uint32_t)get_cycles();
+        fir_naive(fir_y_ref, fir_x, taps, n);
+        naive = (uint32_t)get_cycles() - t0;
+
+        for (uint32_t i = 0; i < n; i++) bad += fir_y[i] != fir_y_ref[i];
+
+        TEST_LOGGER("  taps=");                  print_dec_inline(taps);
+        TEST_LOGGER("  table  cycles/tap=");     print_ratio(fast, umul(n, taps));
+        TEST_LOGGER("  taps=");                  print_dec_inline(taps);
+        TEST_LOGGER("  naive  cycles/tap=");     print_ratio(naive, umul(n, taps));
+    }
+
+    /* Dot product: the same kernels with weights in window order */
+    q16_dot_init(&fir_filter, fir_coeffs, 16);
+    int64_t acc = 0;
+    for (uint32_t k = 0; k < 16; k++) acc += mul_s32_umul(fir_coeffs[k], fir_x[k]);
+    bad += q16_dot(&fir_filter, fir_x) != (int32_t)(acc >> 16);
+
+    report_mismatches(bad);
+}
+
+/* ---------------- fast_rsqrt memo cache replay ---------------- */
+/* Normalization workload: squared magnitudes of 3-D vectors whose components
+ * are quantized to [-q, q] for q in levels[] = {1, 2, 4, 8, 16, 64}; fewer
+ * levels mean more repeats. */
+#define RSQC_MAX_CALLS 1024u
+static uint32_t rsqc_mag2[RSQC_MAX_CALLS];
+
+static void bench_rsqrt_cache(uint32_t n)
+{
+    static const uint32_t levels[] = {1, 2, 4, 8, 16, 64};
+    uint32_t s = 0x9E3779B9u, bad = 0;
+    volatile uint32_t sink = 0;
+
+    TEST_LOGGER("  entries=");
+    print_dec(RSQRT_CACHE_ENTRIES);
+    for (unsigned l = 0; l < sizeof(levels) / sizeof(levels[0]); l++) {
+        uint32_t q = levels[l], span = (q << 1) + 1u;
+
+        for (uint32_t i = 0; i < n; i++) {
+            uint32_t m2 = 0;
+            for (int c = 0; c < 3; c++) {
+                xorshift32(&s);
+                int32_t v = (int32_t)umod(s, span) - (int32_t)q;
+                m2 += umul((uint32_t)(v < 0 ? -v : v), (uint32_t)(v < 0 ? -v : v));
+            }
+            rsqc_mag2[i] = m2;
+        }
+
+        uint32_t t0 = (uint32_t)get_cycles();
+        for (uint32_t i = 0; i < n; i++) sink = fast_rsqrt(rsqc_mag2[i]);
+        uint32_t plain = (uint32_t)get_cycles() - t0;
+
+        rsqrt_cache_reset();
+        t0 = (uint32_t)get_cycles();
+        for (uint32_t i = 0; i < n; i++) sink = fast_rsqrt_cached(rsqc_mag2[i]);
+        uint32_t cached = (uint32_t)get_cycles() - t0;
+        uint32_t hits = rsqrt_cache_counters.hits;
+
+        for (uint32_t i = 0; i < n; i++)
+            bad += fast_rsqrt_cached(rsqc_mag2[i]) != fast_rsqrt(rsqc_mag2[i]);
+
+        TEST_LOGGER("  q=");                      print_dec_inline(q);
+        TEST_LOGGER("  hit%=");                   print_ratio(umul(hits, 100), n);
+        TEST_LOGGER("    cycles/call plain=");    print_ratio(plain, n);
+        TEST_LOGGER("    cycles/call cached=");   print_ratio(cached, n);
+    }
+    (void)sink;
+    report_mismatches(bad);
+}
+
+/* ---------------- ChaCha20 keystream prefetch ----------------
+ * Short records on one stream, each at the next free counter as the
+ * pipeline assigns them; the prefetch cache refills between records, the
+ * part the caller would run while idle, and is left out of the latency. */
+#define CHP_MAX_RECORDS 256u
+#define CHP_MAX_BYTES   256u
+static chacha20_prefetch chp_stream;
+static uint8_t chp_msg[CHP_MAX_BYTES + 4] __attribute__((aligned(4)));
+static uint8_t chp_ref[CHP_MAX_BYTES + 8] __attribute__((aligned(4)));
+static uint8_t chp_out[CHP_MAX_BYTES + 8] __attribute__((aligned(4)));
+
+/* chacha20_prefetch_xor vs chacha20 on the same bytes; also checks that
+ * nothing past len was written. chacha20 itself needs word-aligned buffers,
+ * so the reference runs on an aligned copy. */
+static uint32_t chp_check(uint32_t ctr, uint32_t len, uint32_t align,
+                          const uint8_t *key, const uint8_t *nonce)
+{
+    uint8_t *out = chp_out + align;
+    out[len] = 0xA5;
+    for (uint32_t i = 0; i < len; i++) chp_ref[i] = chp_msg[align + i];
+    chacha20(chp_ref, chp_ref, len, key, nonce, ctr);
+    chacha20_prefetch_xor(&chp_stream, out, chp_msg + align, len, ctr);
+
+    uint32_t bad = out[len] != 0xA5;
+    for (uint32_t i = 0; i < len; i++) bad |= out[i] != chp_ref[i];
+    return bad;
+}
+
+static void bench_chacha20_prefetch(uint32_t records)
+{
+    static const uint8_t key[32]   = {1, 2, 3, 4, 5, 6, 7, 8};
+    static const uint8_t nonce[12] = {0, 0, 0, 0, 0, 0, 0, 74};
+    static const uint32_t sizes[]  = {16, 64, 200};
+    uint32_t bad = 0;
+
+    for (uint32_t i = 0; i < CHP_MAX_BYTES + 4; i++) chp_msg[i] = (uint8_t)(i * 7u + 1u);
+
+    TEST_LOGGER("  prefetch blocks="); print_dec(CHACHA20_PREFETCH_BLOCKS);
+    for (unsigned z = 0; z < sizeof(sizes) / sizeof(sizes[0]); z++) {
+        uint32_t n = sizes[z], blocks = (n + 63u) >> 6, ctr = 1;
+        uint32_t cold = 0, warm = 0, idle = 0, t0;
+
+        chacha20_prefetch_init(&chp_stream, key, nonce, ctr);
+        for (uint32_t r = 0; r < records; r++) {
+            t0 = (uint32_t)get_cycles();
+            chacha20(chp_ref, chp_msg, n, key, nonce, ctr);
+            cold += (uint32_t)get_cycles() - t0;
+
+            t0 = (uint32_t)get_cycles();
+            chacha20_prefetch_fill(&chp_stream);
+            idle += (uint32_t)get_cycles() - t0;
+
+            t0 = (uint32_t)get_cycles();
+            chacha20_prefetch_xor(&chp_stream, chp_out, chp_msg, n, ctr);
+            warm += (uint32_t)get_cycles() - t0;
+
+            for (uint32_t i = 0; i < n; i++) bad += chp_out[i] != chp_ref[i];
+            ctr += blocks;
+        }
+
+        TEST_LOGGER("  bytes=");                     print_dec_inline(n);
+        TEST_LOGGER("  hit blocks=");                print_dec_inline(chp_stream.hit_blocks);
+        TEST_LOGGER("/");                            print_dec(umul(records, blocks));
+        TEST_LOGGER("    latency cycles chacha20="); print_ratio(cold, records);
+        TEST_LOGGER("    latency cycles prefetch="); print_ratio(warm, records);
+        TEST_LOGGER("    idle fill cycles=");        print_ratio(idle, records);
+    }
+
+    /* Invalidation: random counter steps (rewind, repeat, in order, skip),
+     * lengths, alignments and refills; every result must match chacha20 */
+    static const int32_t steps[] = {-2, -1, 0, 1, 1, 1, 2, 5};
+    uint32_t s = 0x2545F491u, ctr = 1000;
+    chacha20_prefetch_init(&chp_stream, key, nonce, ctr);
+    for (uint32_t r = 0; r < 200; r++) {
+        xorshift32(&s);
+        if (s & 1u) chacha20_prefetch_fill(&chp_stream);
+        ctr += (uint32_t)steps[(s >> 1) & 7u];
+        bad += chp_check(ctr, ((s >> 4) & 0xFFu) + 1u, (s >> 12) & 3u, key, nonce);
+    }
+    report_mismatches(bad);
+}
+
+/* ---------------- Platform characterization ----------------
+ * Per-instruction costs of the classes loopcost.py prices, measured with the
+ * platchar.S kernels. Each kernel runs best of PC_RUNS; pc_empty (call +
+ * loop overhead) is subtracted from all of them. The "costs:" lines are a
+ * class=cycles table for `make costs` / `make analyze COSTS=...`. */
+typedef void (*pc_kernel)(uint32_t n, void *arg);
+extern void pc_empty(uint32_t n, void *arg);
+extern void pc_alu(uint32_t n, void *arg);
+extern void pc_chase(uint32_t n, void *arg);
+extern void pc_chase_store(uint32_t n, void *arg);
+extern void pc_branch_nt(uint32_t n, void *arg);
+extern void pc_branch_taken(uint32_t n, void *arg);
+extern void pc_jump(uint32_t n, void *arg);
+extern void pc_indirect(uint32_t n, void *arg);
+extern void pc_call(uint32_t n, void *arg);
+extern void pc_csr(uint32_t n, void *arg);
+extern void pc_ecall(uint32_t n, void *arg);
+
+#define PC_UNROLL     8u   /* instances per iteration, ecall: 4 */
+#define PC_RUNS       3u
+#define PC_MAX_ITERS  4096u
+
+static uint32_t pc_time(pc_kernel k, uint32_t n, void *arg)
+{
+    uint32_t best = 0xFFFFFFFFu;
+    for (uint32_t r = 0; r < PC_RUNS; r++) {
+        uint32_t t0 = (uint32_t)get_cycles();
+        k(n, arg);
+        uint32_t t = (uint32_t)get_cycles() - t0;
+        if (t < best) best = t;
+    }
+    return best;
+}
+
+/* a - b, or 0 when the difference is lost in noise */
+static uint32_t pc_sub(uint32_t a, uint32_t b) { return a > b ? a - b : 0; }
+
+/* One cycle through footprint / stride nodes of chacha20_buf, visited with
+ * an odd step so consecutive loads are not adjacent */
+static void *pc_build_chain(uint32_t stride, uint32_t footprint)
+{
+    uint32_t m = udiv(footprint, stride);   /* a power of two */
+    uint32_t step = (m >> 1) + (m >> 3) + 1u;
+    step |= 1u;
+    uint32_t i = 0;
+    do {
+        uint32_t j = (i + step) & (m - 1u);
+        *(uint32_t *)(chacha20_buf + umul(i, stride)) = (uint32_t)(uintptr_t)(chacha20_buf + umul(j, stride));
+        i = j;
+    } while (i != 0);
+    return chacha20_buf;
+}
+
+static void pc_print_cost(const char *label, uint32_t cycles, uint32_t ops)
+{
+    print_str(label);
+    print_ratio(cycles, ops);
+}
+
+static void bench_platform(uint32_t n)
+{
+    static const uint32_t strides[]    = {4, 16, 64, 256};
+    static const uint32_t footprints[] = {256, 4096, 65536};
+    uint32_t ops = umul(n, PC_UNROLL);
+    uint32_t base = pc_time(pc_empty, n, NULL);
+
+    TEST_LOGGER("  iterations="); print_dec_inline(n);
+    TEST_LOGGER("  loop overhead cycles/iter="); print_ratio(base, n);
+
+    /* Memory: dependent loads (and load + store) over each stride/footprint.
+     * A chase runs at least one lap of its chain, so large footprints take
+     * more than n iterations and are charged their own loop overhead. */
+    uint32_t load_ref = 0, store_ref = 0, ref_ops = ops;
+    for (unsigned f = 0; f < sizeof(footprints) / sizeof(footprints[0]); f++) {
+        for (unsigned z = 0; z < sizeof(strides) / sizeof(strides[0]); z++) {
+            uint32_t stride = strides[z], fp = footprints[f];
+            if (stride > fp) continue;
+            void *head = pc_build_chain(stride, fp);
+            uint32_t lap = udiv(udiv(fp, stride), PC_UNROLL);
+            uint32_t cn = lap > n ? lap : n;
+            uint32_t cops = umul(cn, PC_UNROLL);
+            uint32_t cbase = (cn == n) ? base : pc_time(pc_empty, cn, NULL);
+            uint32_t ld = pc_sub(pc_time(pc_chase, cn, head), cbase);
+
+            TEST_LOGGER("  footprint="); print_dec_inline(fp);
+            TEST_LOGGER(" stride=");     print_dec_inline(stride);
+            TEST_LOGGER(" loads=");      print_dec_inline(cops);
+            TEST_LOGGER("  load=");      print_ratio(ld, cops);
+            if (stride >= 8u) {
+                uint32_t st = pc_sub(pc_sub(pc_time(pc_chase_store, cn, head), cbase), ld);
+                TEST_LOGGER("  footprint="); print_dec_inline(fp);
+                TEST_LOGGER(" stride=");     print_dec_inline(stride);
+                TEST_LOGGER(" loads=");      print_dec_inline(cops);
+                TEST_LOGGER("  store=");     print_ratio(st, cops);
+                if (fp == 4096u && stride == 64u) { load_ref = ld; store_ref = st; ref_ops = cops; }
+            }
+        }
+    }
+
+    uint32_t alu    = pc_sub(pc_time(pc_alu, n, NULL), base);
+    uint32_t nt     = pc_sub(pc_time(pc_branch_nt, n, NULL), base);
+    uint32_t taken  = pc_sub(pc_time(pc_branch_taken, n, NULL), base);
+    uint32_t jump   = pc_sub(pc_time(pc_jump, n, NULL), base);
+    /* one mv per iteration resets the chain: remove one ALU op's share */
+    uint32_t ind    = pc_sub(pc_sub(pc_time(pc_indirect, n, NULL), base), udiv(alu, PC_UNROLL));
+    uint32_t call   = pc_sub(pc_sub(pc_time(pc_call, n, NULL), base), ind);   /* minus the rets */
+    uint32_t csr    = pc_sub(pc_time(pc_csr, n, NULL), base);
+    /* 4 ecalls per iteration, each with 4 ALU ops of argument setup */
+    uint32_t ecall  = pc_sub(pc_sub(pc_time(pc_ecall, n, chacha20_buf), base), alu << 1);
+
+    pc_print_cost("  branch not taken=", nt, ops);
+    pc_print_cost("  branch taken=", taken, ops);
+    pc_print_cost("  jump direct=", jump, ops);
+    pc_print_cost("  jump indirect=", ind, ops);
+    pc_print_cost("  call (ret excluded)=", call, ops);
+    pc_print_cost("  csrr cycle=", csr, ops);
+    pc_print_cost("  SYS_write(0 bytes)=", ecall, n << 2);
+
+    /* loopcost.py classes; load/store from the 4 KB footprint, 64 B stride
+     * row, branch_taken is the extra over a not-taken branch */
+    pc_print_cost("costs: alu=", alu, ops);
+    pc_print_cost("costs: load=", load_ref, ref_ops);
+    pc_print_cost("costs: store=", store_ref, ref_ops);
+    pc_print_cost("costs: branch=", nt, ops);
+    pc_print_cost("costs: branch_taken=", pc_sub(taken, nt), ops);
+    pc_print_cost("costs: jump=", jump, ops);
+    pc_print_cost("costs: call=", call, ops);
+    pc_print_cost("costs: ecall=", ecall, n << 2);
+    pc_print_cost("costs: csr=", csr, ops);
+}
+
+/* ---------------- ChaCha20 session pool ----------------
+ * Gateway traffic: every session sends one packet per round. The pool keeps
+ * key, counter, nonce and leftover keystream per session; the ad-hoc
+ * baseline keeps key/nonce/counter arrays and calls chacha20 per packet,
+ * rounding every packet up to whole blocks. Packets live in chacha20_buf. */
+#define POOL_PKT_BYTES 100u
+#define POOL_ROUNDS    4u
+static chacha20_session *pool_sess[CHACHA20_POOL_SESSIONS];
+static chacha20_packet   pool_pkts[CHACHA20_POOL_SESSIONS];
+static uint8_t  adhoc_key[CHACHA20_POOL_SESSIONS][32] __attribute__((aligned(4)));
+static uint8_t  adhoc_nonce[CHACHA20_POOL_SESSIONS][12] __attribute__((aligned(4)));
+static uint32_t adhoc_ctr[CHACHA20_POOL_SESSIONS];
+static uint8_t  pool_ref[640] __attribute__((aligned(4)));
+
+/* Irregular packet lengths through one session must equal one chacha20
+ * call over the whole message */
+static uint32_t pool_check_stream(void)
+{
+    static const uint8_t key[32]   = {9, 8, 7, 6, 5, 4, 3, 2, 1};
+    static const uint8_t nonce[12] = {0, 0, 0, 9, 0, 0, 0, 74};
+    static const uint8_t lens[]    = {1, 3, 60, 64, 65, 7, 128, 0, 200, 63, 49};
+    uint8_t *msg = chacha20_buf;
+    uint32_t total = 0, bad = 0;
+
+    for (unsigned i = 0; i < sizeof(lens); i++) total += lens[i];
+    for (uint32_t i = 0; i < total; i++) msg[i] = pool_ref[i] = (uint8_t)(i * 13u + 5u);
+    chacha20(pool_ref, pool_ref, total, key, nonce, 7);
+
+    chacha20_session *s = chacha20_session_acquire(key, nonce, 7);
+    if (!s) return 1;
+    for (unsigned i = 0, off = 0; i < sizeof(lens); off += lens[i++])
+        chacha20_session_xor(s, msg + off, msg + off, lens[i]);
+    for (uint32_t i = 0; i < total; i++) bad += msg[i] != pool_ref[i];
+    chacha20_session_release(s);
+    return bad;
+}
+
+/* The same with every packet in its own buffer: odd lengths leave later
+ * packets at any byte offset in the stream, and the buffers themselves sit
+ * at every offset mod 4 */
+static uint32_t pool_check_split(void)
+{
+    static const uint8_t key[32]   = {2, 7, 1, 8, 2, 8, 1, 8};
+    static const uint8_t nonce[12] = {0, 0, 0, 3, 0, 0, 0, 74};
+    static const uint8_t lens[]    = {1, 200, 3, 130, 67, 64, 5};
+    static uint8_t pkt[256 + 3] __attribute__((aligned(4)));
+    uint8_t *msg = chacha20_buf;
+    uint32_t total = 0, bad = 0;
+
+    for (unsigned i = 0; i < sizeof(lens); i++) total += lens[i];
+    for (uint32_t i = 0; i < total; i++) msg[i] = pool_ref[i] = (uint8_t)(i * 7u + 1u);
+    chacha20(pool_ref, pool_ref, total, key, nonce, 3);
+
+    chacha20_session *s = chacha20_session_acquire(key, nonce, 3);
+    if (!s) return 1;
+    for (unsigned i = 0, off = 0; i < sizeof(lens); off += lens[i++]) {
+        uint8_t *out = pkt + ((i + 1u) & 3u);     /* in: msg + off, out: here */
+        chacha20_session_xor(s, out, msg + off, lens[i]);
+        for (uint32_t b = 0; b < lens[i]; b++) bad += out[b] != pool_ref[off + b];
+    }
+    chacha20_session_release(s);
+    return bad;
+}
+
+static void bench_chacha20_pool(uint32_t sessions)
+{
+    uint32_t bad = pool_check_stream() + pool_check_split(), t0, acq = 0;
+    uint32_t packets = umul(sessions, POOL_ROUNDS);
+
+    for (uint32_t i = 0; i < sessions; i++) {
+        uint8_t *key = adhoc_key[i], *nonce = adhoc_nonce[i];
+        for (uint32_t b = 0; b < 32; b++) key[b] = (uint8_t)(i + b);
+        for (uint32_t b = 0; b < 12; b++) nonce[b] = (uint8_t)(i ^ b);
+        adhoc_ctr[i] = 1;
+        t0 = (uint32_t)get_cycles();
+        pool_sess[i] = chacha20_session_acquire(key, nonce, 1);
+        acq += (uint32_t)get_cycles() - t0;
+        bad += pool_sess[i] == NULL;
+    }
+    bad += chacha20_pool_in_use() != sessions;
+
+    for (uint32_t i = 0; i < sessions; i++) {
+        pool_pkts[i].s   = pool_sess[i];
+        pool_pkts[i].out = chacha20_buf + umul(i, POOL_PKT_BYTES);
+        pool_pkts[i].in  = pool_pkts[i].out;
+        pool_pkts[i].len = POOL_PKT_BYTES;
+    }
+
+    t0 = (uint32_t)get_cycles();
+    for (uint32_t r = 0; r < POOL_ROUNDS; r++)
+        chacha20_session_batch(pool_pkts, sessions);
+    uint32_t pooled = (uint32_t)get_cycles() - t0;
+
+    t0 = (uint32_t)get_cycles();
+    for (uint32_t r = 0; r < POOL_ROUNDS; r++) {
+        for (uint32_t i = 0; i < sessions; i++) {
+            uint8_t *pkt = chacha20_buf + umul(i, POOL_PKT_BYTES);
+            chacha20(pkt, pkt, POOL_PKT_BYTES, adhoc_key[i], adhoc_nonce[i], adhoc_ctr[i]);
+            adhoc_ctr[i] += (POOL_PKT_BYTES + 63u) >> 6;
+        }
+    }
+    uint32_t adhoc = (uint32_t)get_cycles() - t0;
+
+    uint32_t rel = 0;
+    for (uint32_t i = 0; i < sessions; i++) {
+        t0 = (uint32_t)get_cycles();
+        chacha20_session_release(pool_sess[i]);
+        rel += (uint32_t)get_cycles() - t0;
+    }
+    bad += chacha20_pool_in_use() != 0;
+
+    /* Released slots come back: fill the whole pool, then one more fails */
+    uint32_t got = 0;
+    while (got < CHACHA20_POOL_SESSIONS &&
+           (pool_sess[got] = chacha20_session_acquire(adhoc_key[0], adhoc_nonce[0], 0)))
+        got++;
+    bad += got != CHACHA20_POOL_SESSIONS;
+    bad += chacha20_session_acquire(adhoc_key[0], adhoc_nonce[0], 0) != NULL;
+    while (got) chacha20_session_release(pool_sess[--got]);
+
+    TEST_LOGGER("  sessions=");               print_dec_inline(sessions);
+    TEST_LOGGER("  capacity=");               print_dec_inline(CHACHA20_POOL_SESSIONS);
+    TEST_LOGGER("  bytes/session=");          print_dec((unsigned long)sizeof(chacha20_session));
+    TEST_LOGGER("  packet bytes=");           print_dec_inline(POOL_PKT_BYTES);
+    TEST_LOGGER("  packets=");                print_dec(packets);
+    TEST_LOGGER("  acquire cycles=");         print_ratio(acq, sessions);
+    TEST_LOGGER("  release cycles=");         print_ratio(rel, sessions);
+    TEST_LOGGER("  pool   packets/Mcycle=");
+    print_ratio(umul(packets, 1000), pooled >= 1000 ? udiv(pooled, 1000) : 1);
+    TEST_LOGGER("  ad hoc packets/Mcycle=");
+    print_ratio(umul(packets, 1000), adhoc >= 1000 ? udiv(adhoc, 1000) : 1);
+    report_mismatches(bad);
+}
+
+/* ---------------- ChaCha20 code size / speed ----------------
+ * Reports the build variant (make CHACHA20_ROLLED=0|1) with its code size
+ * and cycles/byte; run both builds to compare. Every length 1..192 must
+ * equal the keystream of the full-block path XORed in, which covers each
+ * tail word of the partial-block path. */
+static void bench_chacha20_cost(void)
+{
+    static const uint8_t key[32]   = {3, 1, 4, 1, 5, 9, 2, 6};
+    static const uint8_t nonce[12] = {0, 0, 0, 0, 0, 0, 0, 74};
+    static const uint32_t sizes[]  = {64, 256, 1024, 4096, 16384};
+    static uint8_t ks[192] __attribute__((aligned(4)));
+    uint32_t bad = 0;
+
+    TEST_LOGGER("  variant=");
+    if (chacha20_rolled) TEST_LOGGER("rolled");
+    else                 TEST_LOGGER("unrolled");
+    TEST_LOGGER("  code bytes="); print_dec(chacha20_code_bytes);
+
+    for (uint32_t i = 0; i < sizeof(ks); i++) ks[i] = 0;
+    chacha20(ks, ks, sizeof(ks), key, nonce, 5);
+    for (uint32_t n = 1; n <= sizeof(ks); n++) {
+        uint8_t *buf = chacha20_buf;
+        for (uint32_t i = 0; i < n; i++) buf[i] = (uint8_t)(i + n);
+        buf[n] = 0xA5;                /* the tail must stop at n */
+        chacha20(buf, buf, n, key, nonce, 5);
+        for (uint32_t i = 0; i < n; i++) bad += buf[i] != (uint8_t)((i + n) ^ ks[i]);
+        bad += buf[n] != 0xA5;
+    }
+
+    for (unsigned z = 0; z < sizeof(sizes) / sizeof(sizes[0]); z++) {
+        uint32_t n = sizes[z];
+        uint32_t t0 = (uint32_t)get_cycles();
+        chacha20(chacha20_buf, chacha20_buf, n, key, nonce, 1);
+        uint32_t cycles = (uint32_t)get_cycles() - t0;
+        TEST_LOGGER("  bytes=");       print_dec_inline(n);
+        TEST_LOGGER("  cycles/byte="); print_ratio(cycles, n);
+    }
+    report_mismatches(bad);
+}
+
+/* ---------------- Binary trace vs. formatted output ----------------
+ * The moves of one resume puzzle, first printed as text the way
+ * test_Hanoi_resume does, then recorded as HANOI_MOVE trace events and
+ * flushed. The trace frames go to fd (--trace=FD) for tools/tracedecode.py,
+ * or are only counted. */
+#define TRACE_BENCH_MAX_DISKS 10u
+
+static void bench_trace(uint32_t n, int fd)
+{
+    static const char pegs_ch[3] = {'A', 'B', 'C'};
+    uint32_t pos[TRACE_BENCH_MAX_DISKS];
+    uint32_t text_n = 0, trace_n = 0;
+    hanoi_iter it;
+    hanoi_move mv;
+    trace_stats st;
+
+    if (n > TRACE_BENCH_MAX_DISKS) n = TRACE_BENCH_MAX_DISKS;
+    hanoi_random_pos(pos, n);      /* the iterator solves pos[] in place */
+
+    uint32_t t0 = (uint32_t)get_cycles();
+    hanoi_resume_init(&it, pos, n, 2);
+    while (hanoi_resume_next(&it, &mv)) {
+        TEST_LOGGER("Move Disk ");
+        print_dec_inline(mv.disk + 1);
+        TEST_LOGGER(" from ");  print_ch(pegs_ch[mv.from]);
+        TEST_LOGGER(" to ");    print_ch(pegs_ch[mv.to]);
+        print_ch('\n');
+        text_n++;
+    }
+    uint32_t text_cycles = (uint32_t)get_cycles() - t0;
+
+    hanoi_random_pos(pos, n);
+    trace_init(fd);
+    t0 = (uint32_t)get_cycles();
+    hanoi_resume_init(&it, pos, n, 2);
+    while (hanoi_resume_next(&it, &mv)) {
+        TRACE3(HANOI_MOVE, mv.disk + 1, pegs_ch[mv.from], pegs_ch[mv.to]);
+        trace_n++;
+    }
+    trace_flush();
+    uint32_t trace_cycles = (uint32_t)get_cycles() - t0;
+    trace_get_stats(&st);
+
+    TRACE3(COST, trace_n, text_cycles, trace_cycles);
+    trace_flush();
+
+    uint32_t per = trace_n ? trace_n : 1;   /* solved start: no moves */
+    if (trace_cycles == 0) trace_cycles = 1;
+    TEST_LOGGER("  disks=");              print_dec_inline(n);
+    TEST_LOGGER("  events=");             print_dec(text_n);
+    TEST_LOGGER("  text cycles/event=");  print_ratio(text_cycles, per);
+    TEST_LOGGER("  trace cycles/event="); print_ratio(trace_cycles, per);
+    TEST_LOGGER("  text/trace=");         print_ratio(text_cycles, trace_cycles);
+    TEST_LOGGER("  records=");            print_dec_inline(st.records);
+    TEST_LOGGER("  flushes=");            print_dec_inline(st.flushes);
+    TEST_LOGGER("  bytes=");              print_dec(st.bytes);
+    if (fd < 0) TEST_LOGGER("  frames not written (--trace=FD)\n");
+
+    bool ok = text_n == it.moves && st.records == text_n &&
+              st.flushes == udiv(text_n + TRACE_CAPACITY - 1u, TRACE_CAPACITY) &&
+              st.bytes == umul(st.flushes, TRACE_HDR_SIZE) + umul(st.records, TRACE_REC_SIZE);
+    if (ok) TEST_LOGGER("  PASSED\n");
+    else    TEST_LOGGER("  FAILED\n");
+}
+
+/* ---------------- Fixed-point formatting ----------------
+ * Rounding vectors (ties, carries into the integer part, Q0/Q31/Q32,
+ * digits past frac_bits), then n random Q16 values at 4 digits: rendered
+ * only, printed one write per value, and batch-rendered with one write. */
+#define QFMT_BENCH_MAX 256u
+#define QFMT_BENCH_LEN (QFMT_BENCH_MAX * (QFMT_MAX_LEN(4) + 1u))
+
+static bool qfmt_expect(uint32_t raw, uint32_t frac_bits, uint32_t digits, bool is_signed,
+                        const char *want)
+{
+    char buf[QFMT_MAX_LEN(20)];
+    uint32_t len = is_signed ? qfmt_s32(buf, (int32_t)raw, frac_bits, digits)
+                             : qfmt_u32(buf, raw, frac_bits, digits);
+    for (uint32_t i = 0; i < len; i++)
+        if (want[i] != buf[i]) return false;
+    return want[len] == '\0';
+}
+
+static void bench_qfmt(uint32_t n)
+{
+    static const struct {
+        uint32_t    raw, frac_bits, digits;
+        bool        is_signed;
+        const char *want;
+    } vec[] = {
+        {0x00018000u, 16, 0,  false, "2"},             /* 1.5: tie to even */
+        {0x00028000u, 16, 0,  false, "2"},             /* 2.5 */
+        {0x00002000u, 16, 2,  false, "0.12"},          /* 0.125 */
+        {0x00006000u, 16, 2,  false, "0.38"},          /* 0.375 */
+        {0x0001A000u, 16, 1,  false, "1.6"},           /* 1.625 */
+        {0x0000FFFFu, 16, 4,  false, "1.0000"},        /* truncation: 0.9999 */
+        {0xFFFFFFFFu, 16, 4,  false, "65536.0000"},
+        {0xFFFFFFFFu, 0,  0,  false, "4294967295"},
+        {0x80000000u, 31, 3,  true,  "-1.000"},
+        {0x80000000u, 32, 1,  false, "0.5"},
+        {0x00000001u, 32, 12, false, "0.000000000233"},
+        {0xFFFFFFFFu, 16, 20, true,  "-0.00001525878906250000"},
+        {0xFFFFFFFFu, 16, 2,  true,  "-0.00"},
+    };
+    static uint32_t vals[QFMT_BENCH_MAX];
+    static char out[QFMT_BENCH_LEN], one[QFMT_BENCH_LEN];
+    uint32_t bad = 0, s = 0x2545F491u, len, one_len = 0;
+
+    for (unsigned i = 0; i < sizeof(vec) / sizeof(vec[0]); i++)
+        bad += !qfmt_expect(vec[i].raw, vec[i].frac_bits, vec[i].digits,
+                            vec[i].is_signed, vec[i].want);
+
+    if (n > QFMT_BENCH_MAX) n = QFMT_BENCH_MAX;
+    for (uint32_t i = 0; i < n; i++) {
+        xorshift32(&s);
+        vals[i] = s >> (i & 15u);           /* integer parts of every width */
+    }
+
+    uint32_t t0 = (uint32_t)get_cycles();
+    len = qfmt_batch(out, vals, n, 16, 4, false, '\n');
+    uint32_t render = (uint32_t)get_cycles() - t0;
+
+    t0 = (uint32_t)get_cycles();
+    for (uint32_t i = 0; i < n; i++) print_q16_u(vals[i], 4);
+    uint32_t each = (uint32_t)get_cycles() - t0;
+
+    t0 = (uint32_t)get_cycles();
+    len = qfmt_batch(out, vals, n, 16, 4, false, '\n');
+    printstr(out, len);
+    uint32_t batch = (uint32_t)get_cycles() - t0;
+
+    /* the batch is the per-value strings back to back */
+    for (uint32_t i = 0; i < n; i++) {
+        one_len += qfmt_u32(one + one_len, vals[i], 16, 4);
+        one[one_len++] = '\n';
+    }
+    bad += one_len != len;
+    for (uint32_t i = 0; i < len && i < one_len; i++) bad += one[i] != out[i];
+
+    if (n == 0) n = 1;
+    TEST_LOGGER("  render only:       cycles/value="); print_ratio(render, n);
+    TEST_LOGGER("  one write / value: cycles/value="); print_ratio(each, n);
+    TEST_LOGGER("  batch + one write: cycles/value="); print_ratio(batch, n);
+    report_mismatches(bad);
+}
+
+/* ---------------- Command-line options (argv forwarded by _start) ---------------- */
+enum {
+    KERNEL_UF8      = 1u << 0,
+    KERNEL_HANOI    = 1u << 1,
+    KERNEL_RSQRT    = 1u << 2,
+    KERNEL_CHACHA20 = 1u << 3,
+    KERNEL_PIPELINE = 1u << 4,
+    KERNEL_CONV     = 1u << 5,
+    KERNEL_FIR      = 1u << 6,
+    KERNEL_RSQCACHE = 1u << 7,
+    KERNEL_CHACHAPF = 1u << 8,
+    KERNEL_PLATFORM = 1u << 9,
+    KERNEL_POOL     = 1u << 10,
+    KERNEL_CHACOST  = 1u << 11,
+    KERNEL_TRACE    = 1u << 12,
+    KERNEL_QFMT     = 1u << 13,
+};
+#define KERNEL_DEFAULT (KERNEL_UF8 | KERNEL_HANOI | KERNEL_RSQRT)
+#define KERNEL_COUNT   14u
+#define KERNEL_ALL     ((1u << KERNEL_COUNT) - 1u)
+_Static_assert(KERNEL_QFMT == 1u << (KERNEL_COUNT - 1u), "KERNEL_COUNT is stale");
+
+typedef struct {
+    uint32_t lo, hi, step;
+    bool     mul;      /* step is a factor (xF) rather than an increment (+S) */
+    bool     given;
+} param_range;
+
+/* size == 0 selects each kernel's built-in input set. The ranges are only
+ * walked by --sweep; otherwise size is size_r.lo. */
+typedef struct {
+    uint32_t    kernels;
+    uint32_t    size;
+    uint32_t    iters;
+    bool        sweep;
+    int         trace_fd;  /* --trace: fd for trace frames, -1 = count only */
+    param_range size_r;
+    param_range exp_r;
+    param_range align_r;
+} bench_config;
+
+/* One row per kernel, in run order; defined after the run_* drivers */
+typedef struct {
+    const char *name;                        /* --kernel= name */
+    uint32_t    mask;
+    const char *title;                       /* run_timed banner */
+    void      (*run)(const bench_config *cfg);
+    const char *fixed;                       /* --sweep: why not swept, NULL = swept */
+} kernel_desc;
+static const kernel_desc kernel_table[KERNEL_COUNT];
+
+static bool str_eq(const char *a, const char *b)
+{
+    while (*a && *a == *b) { a++; b++; }
+    return *a == *b;
+}
+
+/* If arg is "<name>=<value>", return <value>; otherwise NULL */
+static const char *match_opt(const char *arg, const char *name)
+{
+    while (*name)
+        if (*arg++ != *name++) return NULL;
+    return (*arg == '=') ? arg + 1 : NULL;
+}
+
+/* Decimal or 0x-prefixed hex. Returns the first unconsumed character, or
+ * NULL on an empty number or overflow. */
+static const char *scan_u32(const char *s, uint32_t *out)
+{
+    uint32_t v = 0;
+    const char *start;
+    if (s[0] == '0' && (s[1] == 'x' || s[1] == 'X')) {
+        s += 2;
+        for (start = s; ; s++) {
+            uint32_t d;
+            if (*s >= '0' && *s <= '9')      d = (uint32_t)(*s - '0');
+            else if (*s >= 'a' && *s <= 'f') d = (uint32_t)(*s - 'a' + 10);
+            else if (*s >= 'A' && *s <= 'F') d = (uint32_t)(*s - 'A' + 10);
+            else break;
+            if (v >> 28) return NULL;
+            v = (v << 4) | d;
+        }
+    } else {
+        for (start = s; *s >= '0' && *s <= '9'; s++) {
+            uint32_t d = (uint32_t)(*s - '0');
+            if (v > 429496729u || (v == 429496729u && d > 5u)) return NULL;
+            v = (v << 3) + (v << 1) + d;             /* *10 without M */
+        }
+    }
+    if (s == start) return NULL;
+    *out = v;
+    return s;
+}
+
+/* A whole argument must be one number */
+static bool parse_u32(const char *s, uint32_t *out)
+{
+    s = scan_u32(s, out);
+    return s && !*s;
+}
+
+/* "N", "LO:HI" (step +1), "LO:HI:+S" or "LO:HI:xF" (geometric) */
+static bool parse_range(const char *s, param_range *r)
+{
+    r->step = 1;
+    r->mul  = false;
+    if (!(s = scan_u32(s, &r->lo))) return false;
+    r->hi = r->lo;
+    if (*s == ':') {
+        if (!(s = scan_u32(s + 1, &r->hi))) return false;
+        if (*s == ':') {
+            s++;
+            if (*s == 'x')      r->mul = true;
+            else if (*s != '+') return false;
+            if (!(s = scan_u32(s + 1, &r->step))) return false;
+            if (r->step < (r->mul ? 2u : 1u)) return false;
+        }
+    }
+    r->given = true;
+    return !*s && r->lo <= r->hi;
+}
+
+/* Advance *v to the next point of r; false once past hi (or on overflow) */
+static bool range_next(const param_range *r, uint32_t *v)
+{
+    uint32_t next = r->mul ? umul(*v, r->step) : *v + r->step;
+    if (next <= *v || next > r->hi) return false;
+    *v = next;
+    return true;
+}
+
+/* Comma-separated kernel list, e.g. "uf8,chacha20" */
+static bool parse_kernels(const char *s, uint32_t *out)
+{
+    uint32_t mask = 0;
+    while (*s) {
+        const char *end = s;
+        while (*end && *end != ',') end++;
+
+        uint32_t hit = 0;
+        for (unsigned k = 0; k <= KERNEL_COUNT; k++) {
+            const char *n = (k < KERNEL_COUNT) ? kernel_table[k].name : "all";
+            const char *p = s;
+            while (p < end && *n && *p == *n) { p++; n++; }
+            if (p == end && !*n) { hit = (k < KERNEL_COUNT) ? kernel_table[k].mask : KERNEL_ALL; break; }
+        }
+        if (!hit) return false;
+        mask |= hit;
+        s = *end ? end + 1 : end;
+    }
+    *out = mask;
+    return mask != 0;
+}
+
+static void print_usage(void)
+{
+    TEST_LOGGER("usage: test.elf [--kernel=");
+    for (unsigned k = 0; k < KERNEL_COUNT; k++) {
+        if ((k & 3u) == 0u && k)  TEST_LOGGER(",\n                 ");
+        else if (k)               print_ch(',');
+        print_str(kernel_table[k].name);
+    }
+    TEST_LOGGER("|all] [--size=N] [--iters=N] [--trace=FD]\n"
+                "       test.elf --sweep [--kernel=...] [--size=R] [--exp=R] [--align=R]"
+                " [--iters=N]\n"
+                "  --size  uf8: codes to round-trip (<=256), rsqrt: sweep 1..N,\n"
+                "          chacha20: message bytes (<=65536), pipeline: samples,\n"
+                "          hanoi: disks of a random resume puzzle (<=24),\n"
+                "          conv: values per converter (<=1024), fir: outputs (<=256),\n"
+                "          rsqrt_cache: calls per replay (<=1024),\n"
+                "          chacha20_prefetch: records per size (<=256),\n"
+                "          platform: iterations per microbenchmark (<=4096; chases\n"
+                "            run at least one lap of their footprint),\n"
+                "          chacha20_pool: sessions (<=pool capacity),\n"
+                "          trace: disks of a random resume puzzle (<=10),\n"
+                "          qfmt: Q16 values to format (<=256)\n"
+                "  --trace write binary trace frames to FD (e.g. 2, then 2>trace.bin)\n"
+                "          for tools/tracedecode.py; default: count only. uf8 and\n"
+                "          rsqrt then trace their per-value lines instead of printing\n"
+                "  --sweep cross product of R = N | LO:HI | LO:HI:+S | LO:HI:xF;\n"
+                "          size = inputs (bytes/values/samples), exp = input bucket\n"
+                "          [2^e, 2^(e+1)) for uf8/rsqrt, align = chacha20 byte offset,\n"
+                "          a multiple of 4 (e.g. 0:60:+4; chacha20 moves whole words)\n");
+}
+
+static bool parse_args(int argc, char **argv, bench_config *cfg)
+{
+    cfg->kernels = KERNEL_DEFAULT;
+    cfg->size    = 0;
+    cfg->iters   = 1;
+    cfg->sweep   = false;
+    cfg->trace_fd = -1;
+    cfg->size_r.given  = false;
+    cfg->exp_r.given   = false;
+    cfg->align_r.given = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *val;
+        bool ok;
+
+        if ((val = match_opt(arg, "--kernel")))
+            ok = parse_kernels(val, &cfg->kernels);
+        else if ((val = match_opt(arg, "--size")))
+            ok = parse_range(val, &cfg->size_r);
+        else if ((val = match_opt(arg, "--exp")))
+            ok = parse_range(val, &cfg->exp_r) && cfg->exp_r.hi < 32;
+        else if ((val = match_opt(arg, "--align"))) {
+            /* every point of the range must stay a multiple of 4 */
+            ok = parse_range(val, &cfg->align_r) && cfg->align_r.hi < 64;
+            if (ok && ((cfg->align_r.lo & 3u) ||
+                       (cfg->align_r.hi != cfg->align_r.lo && !cfg->align_r.mul &&
+                        (cfg->align_r.step & 3u)))) {
+                TEST_LOGGER("--align takes multiples of 4: chacha20 loads and stores whole words\n");
+                ok = false;
+            }
+        }
+        else if ((val = match_opt(arg, "--iters")))
+            ok = parse_u32(val, &cfg->iters) && cfg->iters != 0;
+        else if ((val = match_opt(arg, "--trace"))) {
+            uint32_t fd;
+            ok = parse_u32(val, &fd) && fd < 0x80000000u;
+            cfg->trace_fd = (int)fd;
+        }
+        else if (str_eq(arg, "--sweep")) {
+            cfg->sweep = true;
+            ok = true;
+        }
+        else
+            ok = false;
+
+        if (!ok) {
+            TEST_LOGGER("bad option: ");
+            print_str(arg);
+            print_ch('\n');
+            return false;
+        }
+    }
+
+    if (!cfg->sweep &&
+        ((cfg->size_r.given && cfg->size_r.lo != cfg->size_r.hi) ||
+         cfg->exp_r.given || cfg->align_r.given)) {
+        TEST_LOGGER("ranges, --exp and --align need --sweep\n");
+        return false;
+    }
+    if (cfg->size_r.given) cfg->size = cfg->size_r.lo;
+    return true;
+}
+
+/* ---------------- Kernel runners ---------------- */
+static void run_UF8(const bench_config *cfg)
+{
+    uint32_t n = cfg->size ? cfg->size : 8;
+    PERF_REGION_BEGIN("uf8");
+    test_UF8(n > 256 ? 256 : n, cfg->trace_fd);
+    PERF_REGION_END();
+}
+
+static void run_Hanoi(const bench_config *cfg)
+{
+    PERF_REGION_BEGIN("hanoi");
+    if (cfg->size) {
+        bench_Hanoi_resume(cfg->size);
+    } else {
+        test_Hanoi();
+        test_Hanoi_resume();
+    }
+    PERF_REGION_END();
+}
+
+static void run_Fast_rsqrt(const bench_config *cfg)
+{
+    PERF_REGION_BEGIN("rsqrt");
+    if (cfg->size) bench_Fast_rsqrt(cfg->size);
+    else           test_Fast_rsqrt(cfg->trace_fd);
+    PERF_REGION_END();
+}
+
+static void run_chacha20(const bench_config *cfg)
+{
+    PERF_REGION_BEGIN("chacha20_test");
+    if (!cfg->size) test_chacha20();
+    else bench_chacha20(cfg->size > CHACHA20_BENCH_MAX ? CHACHA20_BENCH_MAX : cfg->size);
+    PERF_REGION_END();
+}
+
+static void run_conv(const bench_config *cfg)
+{
+    uint32_t n = cfg->size ? cfg->size : 256;
+    PERF_REGION_BEGIN("conv");
+    bench_conv(n > CONV_MAX ? CONV_MAX : n);
+    PERF_REGION_END();
+}
+
+static void run_fir(const bench_config *cfg)
+{
+    uint32_t n = cfg->size ? cfg->size : 64;
+    PERF_REGION_BEGIN("fir");
+    bench_fir(n > FIR_MAX_OUT ? FIR_MAX_OUT : n);
+    PERF_REGION_END();
+}
+
+static void run_rsqrt_cache(const bench_config *cfg)
+{
+    uint32_t n = cfg->size ? cfg->size : 1024;
+    PERF_REGION_BEGIN("rsqrt_cache");
+    bench_rsqrt_cache(n > RSQC_MAX_CALLS ? RSQC_MAX_CALLS : n);
+    PERF_REGION_END();
+}
+
+static void run_chacha20_prefetch(const bench_config *cfg)
+{
+    uint32_t n = cfg->size ? cfg->size : 32;
+    PERF_REGION_BEGIN("chacha20_prefetch");
+    bench_chacha20_prefetch(n > CHP_MAX_RECORDS ? CHP_MAX_RECORDS : n);
+    PERF_REGION_END();
+}
+
+static void run_platform(const bench_config *cfg)
+{
+    uint32_t n = cfg->size ? cfg->size : 256;
+    PERF_REGION_BEGIN("platform");
+    bench_platform(n > PC_MAX_ITERS ? PC_MAX_ITERS : n);
+    PERF_REGION_END();
+}
+
+static void run_chacha20_pool(const bench_config *cfg)
+{
+    uint32_t n = cfg->size ? cfg->size : 64;
+    PERF_REGION_BEGIN("chacha20_pool");
+    bench_chacha20_pool(n > CHACHA20_POOL_SESSIONS ? CHACHA20_POOL_SESSIONS : n);
+    PERF_REGION_END();
+}
+
+static void run_chacha20_cost(const bench_config *cfg)
+{
+    (void)cfg;
+    PERF_REGION_BEGIN("chacha20_cost");
+    bench_chacha20_cost();
+    PERF_REGION_END();
+}
+
+static void run_trace(const bench_config *cfg)
+{
+    PERF_REGION_BEGIN("trace");
+    bench_trace(cfg->size ? cfg->size : 6, cfg->trace_fd);
+    PERF_REGION_END();
+}
+
+static void run_qfmt(const bench_config *cfg)
+{
+    PERF_REGION_BEGIN("qfmt");
+    bench_qfmt(cfg->size ? cfg->size : 16);
+    PERF_REGION_END();
+}
+
+static void print_stage(const char *name, uint64_t cycles, uint32_t samples)
+{
+    print_str(name);
+    TEST_LOGGER(" cycles=");        print_dec_inline((unsigned long)cycles);
+    TEST_LOGGER("  cycles/sample="); print_dec(udiv((unsigned long)cycles, samples));
+}
+
+static void run_pipeline(const bench_config *cfg)
+{
+    static const char *const stage_names[PIPE_STAGES] = {
+        "  read:    ", "  uf8:     ", "  chacha20:", "  write:   "
+    };
+    pipeline_stats st;
+    uint64_t total = 0;
+
+    PERF_REGION_BEGIN("pipeline");
+    pipeline_run(cfg->size ? cfg->size : 4096, -1, &st);
+    PERF_REGION_END();
+
+    for (int s = 0; s < PIPE_STAGES; s++) {
+        print_stage(stage_names[s], st.cycles[s], st.samples);
+        total += st.cycles[s];
+    }
+    print_stage("  total:   ", total, st.samples);
+    TEST_LOGGER("  samples=");  print_dec_inline(st.samples);
+    TEST_LOGGER("  records=");  print_dec_inline(st.records);
+    TEST_LOGGER("  bytes=");    print_dec_inline(st.bytes_out);
+    TEST_LOGGER("  flushes=");  print_dec(st.flushes);
+}
+
+/* Time cfg->iters back-to-back calls of fn and report the totals */
+static const kernel_desc kernel_table[KERNEL_COUNT] = {
+    {"uf8", KERNEL_UF8, "\n=== Uf8 tests ===\n", run_UF8, NULL},
+    {"hanoi", KERNEL_HANOI, "\n=== Hanoi tower tests ===\n\n", run_Hanoi,
+     "fixed 3-disk input"},
+    {"rsqrt", KERNEL_RSQRT, "\n=== Fast reciprocal square root tests ===\n\n",
+     run_Fast_rsqrt, NULL},
+    {"chacha20", KERNEL_CHACHA20, "\n=== ChaCha20 tests ===\n\n", run_chacha20, NULL},
+    {"pipeline", KERNEL_PIPELINE, "\n=== Telemetry pipeline ===\n\n", run_pipeline, NULL},
+    {"conv", KERNEL_CONV, "\n=== uf8/Q16/f32 converters ===\n\n", run_conv,
+     "fixed code/value set"},
+    {"fir", KERNEL_FIR, "\n=== Q16 FIR / dot product ===\n\n", run_fir,
+     "fixed tap counts"},
+    {"rsqrt_cache", KERNEL_RSQCACHE, "\n=== fast_rsqrt memo cache ===\n\n",
+     run_rsqrt_cache, "fixed levels"},
+    {"chacha20_prefetch", KERNEL_CHACHAPF, "\n=== ChaCha20 keystream prefetch ===\n\n",
+     run_chacha20_prefetch, "fixed sizes"},
+    {"platform", KERNEL_PLATFORM, "\n=== Platform characterization ===\n\n",
+     run_platform, "fixed strides/footprints"},
+    {"chacha20_pool", KERNEL_POOL, "\n=== ChaCha20 session pool ===\n\n",
+     run_chacha20_pool, "fixed packet size"},
+    {"chacha20_cost", KERNEL_CHACOST, "\n=== ChaCha20 code size / speed ===\n\n",
+     run_chacha20_cost, "fixed sizes (see --kernel=chacha20)"},
+    {"trace", KERNEL_TRACE, "\n=== Binary event trace ===\n\n", run_trace,
+     "fixed puzzle"},
+    {"qfmt", KERNEL_QFMT, "\n=== Fixed-point formatting ===\n\n", run_qfmt,
+     "fixed value set"},
+};
+
+static void run_timed(const char *title,
+                      void (*fn)(const bench_config *),
+                      const bench_config *cfg)
 {
     uint64_t start_cycles, end_cycles, cycles_elapsed;
     uint64_t start_instret, end_instret, instret_elapsed;
 
-    /* Test 0: UF8 */
-    TEST_LOGGER("\n=== Uf8 tests ===\n");
+    print_str(title);
     start_cycles   = get_cycles();
     start_instret  = get_instret();
-    test_UF8();
+    for (uint32_t it = 0; it < cfg->iters; it++)
+        fn(cfg);
     end_cycles     = get_cycles();
     end_instret    = get_instret();
     cycles_elapsed   = end_cycles   - start_cycles;
     instret_elapsed  = end_instret  - start_instret;
     TEST_LOGGER("  Cycles: ");       print_dec((unsigned long)cycles_elapsed);
     TEST_LOGGER("  Instructions: "); print_dec((unsigned long)instret_elapsed);
+    if (cfg->iters > 1) {
+        TEST_LOGGER("  Cycles/iter: ");
+        print_dec(udiv((unsigned long)cycles_elapsed, cfg->iters));
+    }
     TEST_LOGGER("\n");
+}
 
-    /* Test 1: Hanoi */
-    TEST_LOGGER("\n=== Hanoi tower tests ===\n\n");
-    start_cycles   = get_cycles();
-    start_instret  = get_instret();
-    test_Hanoi();
-    end_cycles     = get_cycles();
-    end_instret    = get_instret();
-    cycles_elapsed   = end_cycles   - start_cycles;
-    instret_elapsed  = end_instret  - start_instret;
-    TEST_LOGGER("  Cycles: ");       print_dec((unsigned long)cycles_elapsed);
-    TEST_LOGGER("  Instructions: "); print_dec((unsigned long)instret_elapsed);
-    TEST_LOGGER("\n");
+/* ---------------- Parameter sweeps (--sweep) ---------------- */
+/* One CSV row per point of size x exp x align; cycles are the best of
+ * cfg->iters runs and exclude input generation and printing. */
+#define SWEEP_MAX_VALUES 1024u
 
-    /* Test 2: Fast reciprocal square root */
-    TEST_LOGGER("\n=== Fast reciprocal square root tests ===\n\n");
-    start_cycles   = get_cycles();
-    start_instret  = get_instret();
-    test_Fast_rsqrt();
-    end_cycles     = get_cycles();
-    end_instret    = get_instret();
-    cycles_elapsed   = end_cycles   - start_cycles;
-    instret_elapsed  = end_instret  - start_instret;
-    TEST_LOGGER("  Cycles: ");       print_dec((unsigned long)cycles_elapsed);
-    TEST_LOGGER("  Instructions: "); print_dec((unsigned long)instret_elapsed);
-    TEST_LOGGER("\n");
+static uint32_t sweep_vals[SWEEP_MAX_VALUES];
+
+/* n pseudo-random inputs from [2^e, 2^(e+1)), clamped to limit */
+static void sweep_fill(uint32_t n, uint32_t e, uint32_t limit)
+{
+    uint32_t s = 0x9E3779B9u ^ e;
+    uint32_t mask = (1u << e) - 1u;
+    for (uint32_t i = 0; i < n; i++) {
+        xorshift32(&s);
+        uint32_t v = (1u << e) | (s & mask);
+        sweep_vals[i] = (v > limit) ? limit : v;
+    }
+}
+
+static uint32_t sweep_point(uint32_t kernel, uint32_t size,
+                            uint32_t align, uint32_t *units)
+{
+    static const uint8_t key[32]   = {1, 2, 3, 4, 5, 6, 7, 8};
+    static const uint8_t nonce[12] = {0, 0, 0, 0, 0, 0, 0, 74};
+    uint32_t t0 = (uint32_t)get_cycles();
+    volatile uint32_t sink = 0;
+
+    switch (kernel) {
+    case KERNEL_UF8:
+        for (uint32_t i = 0; i < size; i++) sink = uf8_encode(sweep_vals[i]);
+        break;
+    case KERNEL_RSQRT:
+        for (uint32_t i = 0; i < size; i++) sink = fast_rsqrt(sweep_vals[i]);
+        break;
+    case KERNEL_CHACHA20:
+        chacha20(chacha20_buf + align, chacha20_buf + align, size, key, nonce, 1);
+        break;
+    case KERNEL_PIPELINE: {
+        pipeline_stats st;
+        pipeline_run(size, -1, &st);
+        break;
+    }
+    }
+    (void)sink;
+    *units = size;
+    return (uint32_t)get_cycles() - t0;
+}
+
+static void sweep_kernel(const char *name, uint32_t kernel, const bench_config *cfg)
+{
+    param_range size_r  = cfg->size_r;
+    param_range exp_r   = cfg->exp_r;
+    param_range align_r = cfg->align_r;
+    uint32_t max_size   = SWEEP_MAX_VALUES;
+
+    /* default axes per kernel; unused axes collapse to a single point */
+    param_range one_point = {0, 0, 1, false, true};
+    param_range dflt_size = {64, 64, 1, false, true};   /* uf8, rsqrt */
+    param_range dflt_exp  = one_point;
+    if (kernel == KERNEL_UF8)   dflt_exp.hi = 19;
+    if (kernel == KERNEL_RSQRT) dflt_exp.hi = 31;
+    if (kernel == KERNEL_CHACHA20) {
+        param_range r = {1, 4096, 2, true, true};       /* tail path below 64 */
+        dflt_size = r;
+        max_size  = CHACHA20_BENCH_MAX - 64;
+    } else if (kernel == KERNEL_PIPELINE) {
+        param_range r = {64, 4096, 2, true, true};
+        dflt_size = r;
+        max_size  = 0xFFFFFFFFu;
+    }
+    if (!size_r.given) size_r = dflt_size;
+    if (!exp_r.given || !dflt_exp.hi) exp_r = dflt_exp;
+    if (!align_r.given || kernel != KERNEL_CHACHA20) align_r = one_point;
+
+    for (uint32_t e = exp_r.lo; ; ) {
+        for (uint32_t n = size_r.lo; ; ) {
+            uint32_t size = (n > max_size) ? max_size : n;
+            if (kernel == KERNEL_UF8)   sweep_fill(size, e, UF8_MAX);
+            if (kernel == KERNEL_RSQRT) sweep_fill(size, e, 0xFFFFFFFFu);
+
+            for (uint32_t a = align_r.lo; ; ) {
+                uint32_t best = 0xFFFFFFFFu, units = 0;
+                for (uint32_t it = 0; it < cfg->iters; it++) {
+                    uint32_t c = sweep_point(kernel, size, a, &units);
+                    if (c < best) best = c;
+                }
+                print_str(name);
+                print_ch(','); print_dec_inline(size);
+                print_ch(','); print_dec_inline(e);
+                print_ch(','); print_dec_inline(a);
+                print_ch(','); print_dec_inline(units);
+                print_ch(','); print_dec_inline(best);
+                print_ch(','); print_ratio(best, units ? units : 1);
+                if (!range_next(&align_r, &a)) break;
+            }
+            if (!range_next(&size_r, &n)) break;
+        }
+        if (!range_next(&exp_r, &e)) break;
+    }
+}
+
+static void run_sweeps(const bench_config *cfg)
+{
+    TEST_LOGGER("\n=== Sweep ===\n");
+    TEST_LOGGER("kernel,size,exp,align,units,cycles,cycles_per_unit\n");
+    for (unsigned k = 0; k < KERNEL_COUNT; k++) {
+        const kernel_desc *kd = &kernel_table[k];
+        if (!(cfg->kernels & kd->mask)) continue;
+        if (!kd->fixed) {
+            sweep_kernel(kd->name, kd->mask, cfg);
+            continue;
+        }
+        print_str(kd->name);
+        TEST_LOGGER(": ");
+        print_str(kd->fixed);
+        TEST_LOGGER(", not swept\n");
+    }
+}
+
+/* Region tree: name, entries, cycles incl/excl, instret incl/excl */
+static void print_perf_tree(const perf_region *parent, int depth)
+{
+    for (const perf_region *r = perf_region_head; r; r = r->next) {
+        if (r->parent != parent) continue;
+        for (int i = 0; i < depth; i++) TEST_LOGGER("  ");
+        print_str(r->name);
+        TEST_LOGGER("  n=");   print_dec_inline(r->count);
+        TEST_LOGGER("  cyc="); print_dec_inline((unsigned long)r->incl_cycles);
+        print_ch('/');         print_dec_inline((unsigned long)r->excl_cycles);
+        TEST_LOGGER("  ins="); print_dec_inline((unsigned long)r->incl_instret);
+        print_ch('/');         print_dec((unsigned long)r->excl_instret);
+        print_perf_tree(r, depth + 1);
+    }
+}
+
+/* ---------------- Main ---------------- */
+int main(int argc, char **argv)
+{
+    bench_config cfg;
+
+    if (!parse_args(argc, argv, &cfg)) {
+        print_usage();
+        return 1;
+    }
+
+    if (cfg.sweep) {
+        run_sweeps(&cfg);
+        TEST_LOGGER("\n=== All Tests Completed ===\n");
+        return 0;
+    }
+
+    for (unsigned k = 0; k < KERNEL_COUNT; k++)
+        if (cfg.kernels & kernel_table[k].mask)
+            run_timed(kernel_table[k].title, kernel_table[k].run, &cfg);
+
+    if (perf_region_head || perf_region_underflows) {
+        TEST_LOGGER("\n=== Perf regions (cycles incl/excl, instret incl/excl) ===\n");
+        print_perf_tree(NULL, 1);
+        if (perf_region_overflows || perf_region_underflows) {
+            TEST_LOGGER("  ignored: begins past depth ");
+            print_dec_inline(perf_region_max_depth);
+            TEST_LOGGER("=");                print_dec_inline(perf_region_overflows);
+            TEST_LOGGER("  unmatched ends="); print_dec(perf_region_underflows);
+        }
+    }
 
     TEST_LOGGER("\n=== All Tests Completed ===\n");
     return 0;
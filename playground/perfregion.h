@@ -0,0 +1,61 @@
+#ifndef PERFREGION_H
+#define PERFREGION_H
+
+#include <stdint.h>
+
+/* ---------------- Nested performance regions ----------------
+ * PERF_REGION_BEGIN("name") ... PERF_REGION_END() brackets code with a
+ * region. Each call site owns one static descriptor that accumulates over
+ * every entry, and remembers the region it was first entered under so the
+ * report can print a tree.
+ *
+ * Regions nest up to perf_region_max_depth (MAX_DEPTH in perfregion.S)
+ * deep. A deeper BEGIN is ignored together with its END and counted in
+ * perf_region_overflows; an END with no open region is ignored and counted
+ * in perf_region_underflows.
+ *
+ * Inclusive = everything between BEGIN and END, exclusive = inclusive minus
+ * the inclusive time of directly nested regions. Deltas use the low 32 bits of
+ * cycle/instret, so a single entry must stay below 2^32 cycles.
+ *
+ * Overhead, counted on an RV32I instruction model (one cycle per
+ * instruction, call = auipc + jalr): enter runs 20 instructions (32 on a
+ * region's first entry) and exit 61 (55 with no enclosing region). Of
+ * these, 5 cycles / 8 instret per entry fall inside the region's own
+ * inclusive time. The rest, about 78 cycles per BEGIN/END pair (90 on the
+ * first entry), lands in the enclosing region's exclusive time: subtract
+ * count * 78 per child from a parent's exclusive cycles.
+ *
+ * Assembly callers: perfregion.inc has PERF_REGION_DEF/ENTER/EXIT. Both
+ * entry points clobber only ra and t0-t6.
+ *
+ * Layout is shared with perfregion.S; keep the offsets in sync.
+ */
+typedef struct perf_region {
+    const char          *name;          /*  0 */
+    struct perf_region  *parent;        /*  4: set on first entry */
+    struct perf_region  *next;          /*  8: first-entry order */
+    uint32_t             count;         /* 12 */
+    uint64_t             incl_cycles;   /* 16 */
+    uint64_t             excl_cycles;   /* 24 */
+    uint64_t             incl_instret;  /* 32 */
+    uint64_t             excl_instret;  /* 40 */
+} perf_region;
+
+extern perf_region *perf_region_head;   /* every region entered so far */
+extern const uint32_t perf_region_max_depth;
+extern uint32_t perf_region_overflows;
+extern uint32_t perf_region_underflows;
+
+extern void perf_region_enter(perf_region *r);
+extern void perf_region_exit(void);
+
+#define PERF_REGION_BEGIN(label)                                \
+    do {                                                        \
+        static perf_region _perf_region = { .name = (label) };  \
+        perf_region_enter(&_perf_region);                       \
+    } while (0)
+
+#define PERF_REGION_END() perf_region_exit()
+
+#endif /* PERFREGION_H */
@@ -0,0 +1,156 @@
+#include <stdint.h>
+#include <stddef.h>   // for size_t
+
+#include "common.h"
+#include "pipeline.h"
+
+extern uint64_t get_cycles(void);
+extern void *memcpy(void *dest, const void *src, size_t n);
+
+extern void chacha20(uint8_t *out,
+                     const uint8_t *in,
+                     size_t inlen,
+                     const uint8_t *key,
+                     const uint8_t *nonce,
+                     uint32_t ctr);
+
+typedef uint8_t uf8;
+extern uf8 uf8_encode(uint32_t value);
+
+
+static const uint8_t pipe_key[32] = {
+    0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+    0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f,
+    0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27,
+    0x28, 0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f
+};
+static const uint8_t pipe_nonce[12] = {0, 0, 0, 9, 0, 0, 0, 0x4a, 0, 0, 0, 0};
+
+/* ---------------- Sensor source ---------------- */
+/* xorshift32 with a random exponent, saturated to the uf8 range like a real ADC */
+static uint32_t sensor_state = 0x2545F491u;
+
+static void sensor_read(uint32_t *dst, uint32_t n)
+{
+    uint32_t s = sensor_state;
+    for (uint32_t i = 0; i < n; i++) {
+        xorshift32(&s);
+        uint32_t v = (s >> 12) >> (s & 0xFu);
+        dst[i] = (v > UF8_MAX) ? UF8_MAX : v;
+    }
+    sensor_state = s;
+}
+
+/* ---------------- Buffered writer ---------------- */
+typedef struct {
+    uint8_t  *buf;
+    uint32_t  cap;
+    uint32_t  len;
+    int       fd;
+    uint32_t  bytes;
+    uint32_t  flushes;
+} bufwriter;
+
+static void bw_flush(bufwriter *w)
+{
+    if (w->len == 0) return;
+    if (w->fd >= 0) {
+        register long a0 asm("a0") = w->fd;
+        register long a1 asm("a1") = (long)w->buf;
+        register long a2 asm("a2") = (long)w->len;
+        register long a7 asm("a7") = 64;       /* SYS_write */
+        asm volatile("ecall" : "+r"(a0) : "r"(a1), "r"(a2), "r"(a7) : "memory");
+    }
+    w->bytes += w->len;
+    w->flushes++;
+    w->len = 0;
+}
+
+/* Room for n bytes (n <= cap) at the tail, flushing first if needed */
+static uint8_t *bw_reserve(bufwriter *w, uint32_t n)
+{
+    if (w->len + n > w->cap) bw_flush(w);
+    return w->buf + w->len;
+}
+
+static inline void bw_commit(bufwriter *w, uint32_t n) { w->len += n; }
+
+static inline void put_le16(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void put_le32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+/* ---------------- Pipeline ---------------- */
+static uint32_t pipe_samples[PIPE_BATCH];
+static uint8_t  pipe_codes[PIPE_BATCH] __attribute__((aligned(4)));
+static uint8_t  pipe_outbuf[PIPE_OUTBUF_SIZE] __attribute__((aligned(4)));
+
+void pipeline_run(uint32_t nsamples, int fd, pipeline_stats *st)
+{
+    bufwriter w = { pipe_outbuf, PIPE_OUTBUF_SIZE, 0, fd, 0, 0 };
+    uint32_t seq = 0, ctr = 0;
+    uint64_t t0, t1;
+
+    for (int s = 0; s < PIPE_STAGES; s++) st->cycles[s] = 0;
+
+    for (uint32_t done = 0; done < nsamples; done += PIPE_BATCH) {
+        uint32_t n = nsamples - done;
+        if (n > PIPE_BATCH) n = PIPE_BATCH;
+
+        /* 1) read a batch of raw samples */
+        t0 = get_cycles();
+        sensor_read(pipe_samples, n);
+        t1 = get_cycles();
+        st->cycles[PIPE_STAGE_READ] += t1 - t0;
+
+        /* 2) compress to one uf8 code per sample */
+        t0 = t1;
+        for (uint32_t i = 0; i < n; i++)
+            pipe_codes[i] = uf8_encode(pipe_samples[i]);
+        t1 = get_cycles();
+        st->cycles[PIPE_STAGE_COMPRESS] += t1 - t0;
+
+        /* 3) encrypt straight into the record's payload slot; a flush
+         *    triggered here is writer time, not cipher time. */
+        t0 = t1;
+        uint8_t *rec = bw_reserve(&w, PIPE_HDR_SIZE + n);
+        t1 = get_cycles();
+        st->cycles[PIPE_STAGE_WRITE] += t1 - t0;
+
+        t0 = t1;
+        chacha20(rec + PIPE_HDR_SIZE, pipe_codes, n, pipe_key, pipe_nonce, ctr);
+        t1 = get_cycles();
+        st->cycles[PIPE_STAGE_ENCRYPT] += t1 - t0;
+
+        /* 4) frame and hand to the buffered writer */
+        t0 = t1;
+        rec[0] = 'T';
+        rec[1] = 'F';
+        put_le16(rec + 2, n);
+        put_le32(rec + 4, seq);
+        put_le32(rec + 8, ctr);
+        bw_commit(&w, PIPE_HDR_SIZE + n);
+        seq++;
+        ctr += (n + 63u) >> 6;
+        t1 = get_cycles();
+        st->cycles[PIPE_STAGE_WRITE] += t1 - t0;
+    }
+
+    t0 = get_cycles();
+    bw_flush(&w);
+    st->cycles[PIPE_STAGE_WRITE] += get_cycles() - t0;
+
+    st->samples   = nsamples;
+    st->records   = seq;
+    st->bytes_out = w.bytes;
+    st->flushes   = w.flushes;
+}
@@ -0,0 +1,42 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <stdint.h>
+
+/* ---------------- Sensor telemetry pipeline ----------------
+ * read (32-bit samples) -> uf8_encode -> chacha20 -> framed, buffered output
+ *
+ * Each batch of up to PIPE_BATCH samples becomes one record:
+ *   [0..1]  'T','F'         magic
+ *   [2..3]  payload length  (little-endian, bytes == samples in the batch)
+ *   [4..7]  sequence number (little-endian)
+ *   [8..11] ChaCha20 block counter the payload was encrypted with
+ *   [12..]  payload: uf8 codes XOR keystream
+ * The counter advances by ceil(len / 64) per record, so a receiver holding
+ * the key/nonce can decrypt any record on its own.
+ */
+#define PIPE_BATCH       64u     /* samples per record: one ChaCha20 block */
+#define PIPE_HDR_SIZE    12u
+#define PIPE_OUTBUF_SIZE 1024u   /* writer buffer; holds several records */
+
+enum {
+    PIPE_STAGE_READ,
+    PIPE_STAGE_COMPRESS,
+    PIPE_STAGE_ENCRYPT,
+    PIPE_STAGE_WRITE,
+    PIPE_STAGES
+};
+
+typedef struct {
+    uint64_t cycles[PIPE_STAGES];
+    uint32_t samples;
+    uint32_t records;
+    uint32_t bytes_out;
+    uint32_t flushes;
+} pipeline_stats;
+
+/* Push nsamples through the pipeline. Records go to fd via SYS_write, or
+ * are only counted when fd < 0 (keeps binary output off the console). */
+void pipeline_run(uint32_t nsamples, int fd, pipeline_stats *st);
+
+#endif /* PIPELINE_H */
@@ -0,0 +1,141 @@
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "q16dsp.h"
+
+/* Per-nibble accumulators a0..a7 and the sign correction an. Each table
+ * entry is below 2^20 in magnitude, so Q16_FIR_MAX_TAPS of them fit in 32
+ * bits; nothing is shifted until fir_finish. */
+#define FIR_DECL                                                        \
+    int32_t a0 = 0, a1 = 0, a2 = 0, a3 = 0, a4 = 0, a5 = 0, a6 = 0, a7 = 0; \
+    int32_t an = 0
+
+/* One tap: the nibbles of x pick w * nibble from the tap's table; shifting
+ * and masking with 0x3C yields the byte offset (nibble * 4) directly. A
+ * negative x is u - 2^32 for its unsigned bits u, so the tap also adds w
+ * to the 2^32 correction term. */
+#define FIR_TAP(k)                                                      \
+    do {                                                                \
+        uint32_t xv = (uint32_t)x[k];                                   \
+        const uint8_t *t = (const uint8_t *)f->tab[k];                  \
+        a0 += *(const int32_t *)(t + ((xv << 2)  & 0x3Cu));             \
+        a1 += *(const int32_t *)(t + ((xv >> 2)  & 0x3Cu));             \
+        a2 += *(const int32_t *)(t + ((xv >> 6)  & 0x3Cu));             \
+        a3 += *(const int32_t *)(t + ((xv >> 10) & 0x3Cu));             \
+        a4 += *(const int32_t *)(t + ((xv >> 14) & 0x3Cu));             \
+        a5 += *(const int32_t *)(t + ((xv >> 18) & 0x3Cu));             \
+        a6 += *(const int32_t *)(t + ((xv >> 22) & 0x3Cu));             \
+        a7 += *(const int32_t *)(t + ((xv >> 26) & 0x3Cu));             \
+        an += f->w[k] & (int32_t)(0u - (xv >> 31));                     \
+    } while (0)
+
+#define FIR_TAP4(k)                                                     \
+    do {                                                                \
+        FIR_TAP(k);                                                     \
+        FIR_TAP((k) + 1);                                               \
+        FIR_TAP((k) + 2);                                               \
+        FIR_TAP((k) + 3);                                               \
+    } while (0)
+
+#define FIR_FINISH return fir_finish(a0, a1, a2, a3, a4, a5, a6, a7, an)
+
+/* sum_j a_j * 16^j - an * 2^32, then floor(/2^16) saturated to int32.
+ * Unsigned 64-bit Horner steps keep every shift constant and well defined. */
+static inline int32_t fir_finish(int32_t a0, int32_t a1, int32_t a2, int32_t a3,
+                                 int32_t a4, int32_t a5, int32_t a6, int32_t a7,
+                                 int32_t an)
+{
+    uint64_t u = (uint64_t)(int64_t)a7;
+    u = (u << 4) + (uint64_t)(int64_t)a6;
+    u = (u << 4) + (uint64_t)(int64_t)a5;
+    u = (u << 4) + (uint64_t)(int64_t)a4;
+    u = (u << 4) + (uint64_t)(int64_t)a3;
+    u = (u << 4) + (uint64_t)(int64_t)a2;
+    u = (u << 4) + (uint64_t)(int64_t)a1;
+    u = (u << 4) + (uint64_t)(int64_t)a0;
+    u -= (uint64_t)(int64_t)an << 32;
+
+    int64_t s = (int64_t)u >> 16;   /* |sum| < 2^53: no wrap above */
+    if (s > INT32_MAX) return INT32_MAX;
+    if (s < INT32_MIN) return INT32_MIN;
+    return (int32_t)s;
+}
+
+/* ---------------- Kernels, unrolled by tap count ---------------- */
+static int32_t dot_4(const q16_fir *f, const int32_t *x)
+{
+    FIR_DECL;
+    FIR_TAP4(0);
+    FIR_FINISH;
+}
+
+static int32_t dot_8(const q16_fir *f, const int32_t *x)
+{
+    FIR_DECL;
+    FIR_TAP4(0);
+    FIR_TAP4(4);
+    FIR_FINISH;
+}
+
+static int32_t dot_16(const q16_fir *f, const int32_t *x)
+{
+    FIR_DECL;
+    FIR_TAP4(0);
+    FIR_TAP4(4);
+    FIR_TAP4(8);
+    FIR_TAP4(12);
+    FIR_FINISH;
+}
+
+/* Any tap count: four taps per iteration, then the remainder */
+static int32_t dot_any(const q16_fir *f, const int32_t *x)
+{
+    FIR_DECL;
+    uint32_t k = 0;
+    for (; k + 4u <= f->ntaps; k += 4u)
+        FIR_TAP4(k);
+    for (; k < f->ntaps; k++)
+        FIR_TAP(k);
+    FIR_FINISH;
+}
+
+/* ---------------- Setup ---------------- */
+static bool init_window(q16_fir *f, const int32_t *w, uint32_t ntaps, bool reverse)
+{
+    if (ntaps == 0u || ntaps > Q16_FIR_MAX_TAPS) return false;
+
+    for (uint32_t k = 0; k < ntaps; k++) {
+        int32_t wk = w[reverse ? ntaps - 1u - k : k];
+        if (wk <= -65536 || wk >= 65536) return false;
+
+        int32_t *t = f->tab[k], p = 0;
+        for (uint32_t n = 0; n < 16u; n++) {   /* w * n by repeated adds */
+            t[n] = p;
+            p += wk;
+        }
+        f->w[k] = wk;
+    }
+    f->ntaps = ntaps;
+    f->dot = (ntaps == 4u)  ? dot_4
+           : (ntaps == 8u)  ? dot_8
+           : (ntaps == 16u) ? dot_16
+           : dot_any;
+    return true;
+}
+
+bool q16_dot_init(q16_fir *f, const int32_t *weights, uint32_t ntaps)
+{
+    return init_window(f, weights, ntaps, false);
+}
+
+bool q16_fir_init(q16_fir *f, const int32_t *coeffs, uint32_t ntaps)
+{
+    return init_window(f, coeffs, ntaps, true);
+}
+
+void q16_fir_run(const q16_fir *f, int32_t *y, const int32_t *x, uint32_t n)
+{
+    int32_t (*dot)(const q16_fir *, const int32_t *) = f->dot;
+    for (uint32_t i = 0; i < n; i++)
+        y[i] = dot(f, x + i);
+}
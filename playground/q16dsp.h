@@ -0,0 +1,52 @@
+#ifndef Q16DSP_H
+#define Q16DSP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* ---------------- Q16 dot product / FIR without a multiplier ----------------
+ * Weights are fixed for the lifetime of a filter, so init expands each one
+ * into a partial-product table w * 0..15 that every sample reuses. A tap is
+ * then eight table lookups indexed by the nibbles of the sample, added into
+ * one 32-bit accumulator per nibble position; the shifts that weight those
+ * accumulators are applied once per output, in 64 bits. The tables belong
+ * to the weights, not to the samples: built once, they cost nothing per
+ * output, where a per-sample table shared across taps would be rebuilt for
+ * every sample.
+ *
+ * Ranges: weights |w| < 1.0 (|raw| < 2^16), samples any int32 Q16,
+ * at most Q16_FIR_MAX_TAPS taps. Outputs are floor(sum(w * x) / 2^16),
+ * exact and saturated to int32, so they match a full 64-bit computation.
+ *
+ * A q16_fir holds 64 bytes of table per tap; keep it static (the stack is
+ * 4 KB).
+ */
+#define Q16_FIR_MAX_TAPS 64u
+
+typedef struct q16_fir q16_fir;
+
+struct q16_fir {
+    uint32_t ntaps;
+    int32_t  (*dot)(const q16_fir *f, const int32_t *x);   /* unrolled by ntaps */
+    int32_t  w[Q16_FIR_MAX_TAPS];                          /* window order */
+    int32_t  tab[Q16_FIR_MAX_TAPS][16];                    /* w[k] * n, n = 0..15 */
+};
+
+/* Build the tables; false if ntaps is 0 or too large, or a weight is out of
+ * range. Tap counts 4, 8 and 16 get fully unrolled kernels.
+ *   q16_dot_init: w[k] = weights[k]            (dot products)
+ *   q16_fir_init: w[k] = coeffs[ntaps - 1 - k] (convolution) */
+bool q16_dot_init(q16_fir *f, const int32_t *weights, uint32_t ntaps);
+bool q16_fir_init(q16_fir *f, const int32_t *coeffs, uint32_t ntaps);
+
+/* sum_k w[k] * x[k] */
+static inline int32_t q16_dot(const q16_fir *f, const int32_t *x)
+{
+    return f->dot(f, x);
+}
+
+/* y[i] = sum_k coeffs[k] * x[i + ntaps - 1 - k] for i in [0, n):
+ * x holds ntaps - 1 history samples followed by n new ones. */
+void q16_fir_run(const q16_fir *f, int32_t *y, const int32_t *x, uint32_t n);
+
+#endif /* Q16DSP_H */
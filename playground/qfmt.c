@@ -0,0 +1,89 @@
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "qfmt.h"
+
+static const uint32_t pow10[9] = {
+    1000000000u, 100000000u, 10000000u, 1000000u, 100000u,
+    10000u, 1000u, 100u, 10u
+};
+
+/* x in decimal, no leading zeros; at most 9 subtractions per digit */
+static char *put_uint(char *p, uint32_t x)
+{
+    uint32_t i = 0;
+    while (i < 9u && x < pow10[i]) i++;
+    for (; i < 9u; i++) {
+        uint32_t p10 = pow10[i];
+        char d = '0';
+        while (x >= p10) { x -= p10; d++; }
+        *p++ = d;
+    }
+    *p++ = (char)('0' + x);
+    return p;
+}
+
+static char *put_mag(char *p, uint32_t mag, uint32_t frac_bits, uint32_t digits)
+{
+    char d[32];                 /* significant fraction digits, <= frac_bits */
+    uint32_t ip, f, nd = 0;
+
+    if (frac_bits == 0u)       { ip = mag;              f = 0u; }
+    else if (frac_bits >= 32u) { ip = 0u;               f = mag; }
+    else                       { ip = mag >> frac_bits; f = mag << (32u - frac_bits); }
+
+    /* f is the exact fraction * 2^32; it reaches 0 within frac_bits digits */
+    while (nd < digits && f) {
+        uint32_t f8 = f << 3, lo = f8 + (f << 1);
+        d[nd++] = (char)('0' + (f >> 29) + (f >> 31) + (lo < f8));
+        f = lo;
+    }
+
+    /* f != 0 only if digits < frac_bits: the rest is f / 2^32 of a unit */
+    if (f > 0x80000000u || (f == 0x80000000u && ((nd ? (uint32_t)d[nd - 1] : ip) & 1u))) {
+        uint32_t i = nd;
+        while (i && d[i - 1] == '9') d[--i] = '0';
+        if (i) d[i - 1]++;
+        else   ip++;                    /* frac_bits >= 1: ip < 2^31 */
+    }
+
+    p = put_uint(p, ip);
+    if (digits) {
+        *p++ = '.';
+        for (uint32_t i = 0; i < nd; i++) *p++ = d[i];
+        for (uint32_t i = nd; i < digits; i++) *p++ = '0';
+    }
+    return p;
+}
+
+uint32_t qfmt_u32(char *dst, uint32_t raw, uint32_t frac_bits, uint32_t digits)
+{
+    return (uint32_t)(put_mag(dst, raw, frac_bits, digits) - dst);
+}
+
+uint32_t qfmt_s32(char *dst, int32_t raw, uint32_t frac_bits, uint32_t digits)
+{
+    char *p = dst;
+    uint32_t mag = (uint32_t)raw;
+    if (raw < 0) {
+        *p++ = '-';
+        mag = 0u - mag;
+    }
+    return (uint32_t)(put_mag(p, mag, frac_bits, digits) - dst);
+}
+
+uint32_t qfmt_batch(char *dst, const uint32_t *src, uint32_t n, uint32_t frac_bits,
+                    uint32_t digits, bool is_signed, char sep)
+{
+    char *p = dst;
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t mag = src[i];
+        if (is_signed && (mag >> 31)) {
+            *p++ = '-';
+            mag = 0u - mag;
+        }
+        p = put_mag(p, mag, frac_bits, digits);
+        *p++ = sep;
+    }
+    return (uint32_t)(p - dst);
+}
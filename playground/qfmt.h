@@ -0,0 +1,34 @@
+#ifndef QFMT_H
+#define QFMT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* ---------------- Fixed-point decimal formatter ----------------
+ * Renders a raw 32-bit value with frac_bits fraction bits (Q0..Q32) as
+ * "[-]int[.frac]" with exactly `digits` fractional digits, correctly
+ * rounded: to nearest, ties to even, as printf("%.*f") prints the same
+ * value. A Qn fraction has at most n significant decimal digits, so digits
+ * beyond frac_bits are exact zeros and any digit count works.
+ *
+ * No division and no multiply: the fraction is left-aligned in 32 bits and
+ * each digit is the carry out of f * 10 = (f << 3) + (f << 1); what is left
+ * in f after the last digit decides the rounding. Integer parts are
+ * converted by subtracting powers of ten.
+ *
+ * Functions write into dst without a terminating NUL and return the byte
+ * count. Negative values keep their sign even when they round to zero
+ * ("-0.00"), like printf.
+ */
+#define QFMT_MAX_LEN(digits) (12u + (digits))  /* sign, 10 int digits, '.' */
+
+uint32_t qfmt_u32(char *dst, uint32_t raw, uint32_t frac_bits, uint32_t digits);
+uint32_t qfmt_s32(char *dst, int32_t raw, uint32_t frac_bits, uint32_t digits);
+
+/* n values, each followed by sep, into one buffer of at least
+ * n * (QFMT_MAX_LEN(digits) + 1) bytes; src holds raw bit patterns, read as
+ * int32_t when is_signed. Flush the result with a single write. */
+uint32_t qfmt_batch(char *dst, const uint32_t *src, uint32_t n, uint32_t frac_bits,
+                    uint32_t digits, bool is_signed, char sep);
+
+#endif /* QFMT_H */
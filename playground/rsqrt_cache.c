@@ -0,0 +1,57 @@
+#include <stdint.h>
+
+#include "rsqrt_cache.h"
+
+extern uint32_t fast_rsqrt(uint32_t x);
+
+rsqrt_cache_stats rsqrt_cache_counters;
+
+#if RSQRT_CACHE_BITS > 0
+static uint32_t cache_key[RSQRT_CACHE_ENTRIES];
+static uint32_t cache_val[RSQRT_CACHE_ENTRIES];
+
+/* Fold every bit of x into the index: squared magnitudes of quantized
+ * vectors differ in their low and middle bits alike. */
+static inline uint32_t cache_index(uint32_t x)
+{
+    x ^= x >> 16;
+    x ^= x >> RSQRT_CACHE_BITS;
+    return x & (RSQRT_CACHE_ENTRIES - 1u);
+}
+
+uint32_t fast_rsqrt_cached(uint32_t x)
+{
+    uint32_t i = cache_index(x);
+    if (cache_key[i] == x) {
+        rsqrt_cache_counters.hits++;
+        return cache_val[i];
+    }
+    uint32_t y = fast_rsqrt(x);
+    cache_key[i] = x;
+    cache_val[i] = y;
+    rsqrt_cache_counters.misses++;
+    return y;
+}
+
+void rsqrt_cache_reset(void)
+{
+    for (uint32_t i = 0; i < RSQRT_CACHE_ENTRIES; i++) {
+        cache_key[i] = 0;
+        cache_val[i] = 0;
+    }
+    rsqrt_cache_counters.hits = 0;
+    rsqrt_cache_counters.misses = 0;
+}
+#else
+uint32_t fast_rsqrt_cached(uint32_t x)
+{
+    rsqrt_cache_counters.misses++;
+    return fast_rsqrt(x);
+}
+
+void rsqrt_cache_reset(void)
+{
+    rsqrt_cache_counters.hits = 0;
+    rsqrt_cache_counters.misses = 0;
+}
+#endif
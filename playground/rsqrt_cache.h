@@ -0,0 +1,32 @@
+#ifndef RSQRT_CACHE_H
+#define RSQRT_CACHE_H
+
+#include <stdint.h>
+
+/* ---------------- Direct-mapped memo cache for fast_rsqrt ----------------
+ * fast_rsqrt_cached(x) == fast_rsqrt(x); on a hit it skips the CLZ, LUT
+ * interpolation and Newton step. 2^RSQRT_CACHE_BITS entries of {x, y},
+ * indexed by a shift/xor fold of x; a miss computes and replaces the slot.
+ *
+ * Size it at build time (make RSQRT_CACHE_BITS=n); 0 turns the cache into
+ * a counted pass-through. The zeroed .bss is already a valid cache:
+ * fast_rsqrt(0) == 0.
+ */
+#ifndef RSQRT_CACHE_BITS
+#define RSQRT_CACHE_BITS 6
+#endif
+#define RSQRT_CACHE_ENTRIES (1u << RSQRT_CACHE_BITS)
+
+typedef struct {
+    uint32_t hits;
+    uint32_t misses;
+} rsqrt_cache_stats;
+
+extern rsqrt_cache_stats rsqrt_cache_counters;
+
+uint32_t fast_rsqrt_cached(uint32_t x);
+
+/* Empty the cache and zero the counters */
+void rsqrt_cache_reset(void);
+
+#endif /* RSQRT_CACHE_H */
@@ -0,0 +1,281 @@
+#!/usr/bin/env python3
+"""Incremental benchmark runner for test.elf.
+
+    tools/benchrun.py --emu EMU [--elf test.elf] [--bench K[:SIZE[:ITERS]]]...
+                      [--baseline FILE] [--save-baseline FILE] [--force]
+
+A benchmark is one kernel run, test.elf --kernel=K [--size=SIZE]
+[--iters=ITERS]; without --bench every kernel in KERNEL_DRIVERS runs with
+its defaults. Each benchmark gets a key hashing
+  - its driver in main.o: the run_* function and every main.o function it
+    reaches through relocations, plus the data those reference: the
+    covering object for a reference to static data (gas emits those as
+    section + addend), the string for a literal, else the whole section;
+  - the allocated sections of every object file that closure pulls in
+    through undefined symbols, transitively (quiz1_uf8.o, chacha20_asm.o,
+    perfcounter.o, ...), so debug info and comments do not count;
+  - its arguments and the emulator binary.
+A benchmark whose key matches the cache reuses the stored output, the rest
+run under the emulator. The report covers every benchmark either way, with
+cycles against --baseline (a file written by --save-baseline).
+
+The main.o closure follows the call relocations RISC-V keeps for linker
+relaxation (the Makefile does not pass -mno-relax). Not tracked: main()
+and option parsing, the linker script and code placement. --force reruns
+everything.
+"""
+
+import argparse
+import hashlib
+import json
+import os
+import re
+import subprocess
+import sys
+
+from elfobj import (ElfObject, SHF_ALLOC, SHF_EXECINSTR, SHF_STRINGS, SHN_UNDEF,
+                    STT_FUNC, STT_OBJECT)
+
+# --kernel name -> driver function in main.c
+KERNEL_DRIVERS = {
+    "uf8": "run_UF8",
+    "hanoi": "run_Hanoi",
+    "rsqrt": "run_Fast_rsqrt",
+    "chacha20": "run_chacha20",
+    "pipeline": "run_pipeline",
+    "conv": "run_conv",
+    "fir": "run_fir",
+    "rsqrt_cache": "run_rsqrt_cache",
+    "chacha20_prefetch": "run_chacha20_prefetch",
+    "platform": "run_platform",
+    "chacha20_pool": "run_chacha20_pool",
+    "chacha20_cost": "run_chacha20_cost",
+    "trace": "run_trace",
+    "qfmt": "run_qfmt",
+}
+
+CYCLES_RE = re.compile(r"^\s*Cycles: (\d+)", re.M)
+INSTRET_RE = re.compile(r"^\s*Instructions: (\d+)", re.M)
+
+
+def driver_digest(obj, root, h):
+    """Hash root and the functions it reaches in obj, plus the data those
+    reference; return the undefined symbols that closure references."""
+    index = {s.name: i for i, s in enumerate(obj.symbols)
+             if s.type == STT_FUNC and s.shndx != SHN_UNDEF}
+    if root not in index:
+        sys.exit("%s: no function %s" % (obj.path, root))
+    # data symbols by section, to map section + addend back to an object
+    objects = {}
+    for s in obj.symbols:
+        if s.type == STT_OBJECT and s.size and s.shndx < len(obj.sections):
+            objects.setdefault(s.shndx, []).append(s)
+    seen, stack, externs = set(), [(index[root],)], set()
+
+    def follow(shndx, start, end):
+        """Queue the relocation targets inside [start, end) of a section."""
+        for off, typ, ti, addend in obj.relocs.get(shndx, []):
+            if not start <= off < end:
+                continue
+            t = obj.symbols[ti]
+            h.update(b"%d:%d:%s:%d;" % (off - start, typ, t.name.encode(), addend))
+            if t.shndx == SHN_UNDEF:
+                if t.name:
+                    externs.add(t.name)
+            elif t.type == STT_FUNC:
+                stack.append((ti,))
+            elif t.shndx < len(obj.sections):
+                stack.append((t.shndx, t.value + addend))
+
+    while stack:
+        item = stack.pop()
+        if len(item) == 1:
+            if item in seen:
+                continue
+            seen.add(item)
+            fn = obj.symbols[item[0]]
+            h.update(fn.name.encode() + b"\0")
+            h.update(obj.contents(fn.shndx, fn.value, fn.size))
+            follow(fn.shndx, fn.value, fn.value + fn.size)
+            continue
+
+        # data: gas turns references to static data into section + addend
+        # (or .L labels), so find the object covering the target; without
+        # one, hash the whole section. Code labels are already covered by
+        # the function that contains them.
+        shndx, off = item
+        sec = obj.sections[shndx]
+        if not sec[2] & SHF_ALLOC or sec[2] & SHF_EXECINSTR:
+            continue
+        if sec[2] & SHF_STRINGS:
+            data = obj.contents(shndx, 0, sec[5])
+            end = data.find(b"\0", off) + 1 if 0 <= off < len(data) else 0
+            start, end = (off, end) if end else (0, sec[5])
+        else:
+            cover = [s for s in objects.get(shndx, [])
+                     if s.value <= off < s.value + s.size]
+            start, end = ((cover[0].value, cover[0].value + cover[0].size)
+                          if cover else (0, sec[5]))
+        if (shndx, start, end) in seen:
+            continue
+        seen.add((shndx, start, end))
+        h.update(b"%s+%d:" % (obj.names[shndx].encode(), start))
+        h.update(obj.contents(shndx, start, end - start))
+        follow(shndx, start, end)
+    return externs
+
+
+def makefile_objs(makefile):
+    with open(makefile) as f:
+        for line in f:
+            m = re.match(r"^OBJS\s*=\s*(.*)$", line)
+            if m:
+                return m.group(1).split()
+    sys.exit("%s: no OBJS line" % makefile)
+
+
+def file_digest(path):
+    h = hashlib.sha256()
+    with open(path, "rb") as f:
+        h.update(f.read())
+    return h.hexdigest()
+
+
+def bench_key(objs, main_obj, driver, args, emu_hash):
+    h = hashlib.sha256()
+    pending = driver_digest(main_obj, driver, h)
+    owner = {}
+    for o in objs.values():
+        for name in o.defined():
+            owner.setdefault(name, o)
+    used, resolved = set(), set()
+    while pending:
+        name = pending.pop()
+        if name in resolved:
+            continue
+        resolved.add(name)
+        o = owner.get(name)
+        if o is main_obj:
+            pending |= driver_digest(main_obj, name, h)   # e.g. memcpy
+            continue
+        if o is None or o.path in used:
+            h.update(b"extern:%s;" % name.encode())
+            continue
+        used.add(o.path)
+        pending |= o.undefined()
+    for path in sorted(used):
+        h.update(os.path.basename(path).encode() + b"\0")
+        objs[path].alloc_digest(h)
+    h.update(" ".join(args).encode() + b"\0" + emu_hash.encode())
+    return h.hexdigest(), sorted(os.path.basename(p) for p in used)
+
+
+def parse_bench(spec):
+    parts = spec.split(":")
+    if parts[0] not in KERNEL_DRIVERS or len(parts) > 3:
+        raise argparse.ArgumentTypeError("bad benchmark '%s'" % spec)
+    args = ["--kernel=" + parts[0]]
+    if len(parts) > 1 and parts[1]:
+        args.append("--size=" + parts[1])
+    if len(parts) > 2 and parts[2]:
+        args.append("--iters=" + parts[2])
+    return spec, parts[0], args
+
+
+def summarize(output):
+    c, i = CYCLES_RE.search(output), INSTRET_RE.search(output)
+    return {
+        "cycles": int(c.group(1)) if c else None,
+        "instret": int(i.group(1)) if i else None,
+        "passed": output.count("PASSED"),
+        "failed": output.count("FAILED"),
+    }
+
+
+def load_json(path):
+    if path and os.path.exists(path):
+        with open(path) as f:
+            return json.load(f)
+    return {}
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    ap.add_argument("--emu", required=True, help="rv32emu binary")
+    ap.add_argument("--elf", default="test.elf")
+    ap.add_argument("--makefile", default="Makefile", help="OBJS source")
+    ap.add_argument("--bench", action="append", type=parse_bench,
+                    help="KERNEL[:SIZE[:ITERS]] (repeatable)")
+    ap.add_argument("--cache", default=".benchcache.json")
+    ap.add_argument("--baseline", help="report saved by --save-baseline")
+    ap.add_argument("--save-baseline", help="write this run's cycles here")
+    ap.add_argument("--output", help="write every benchmark's guest output here")
+    ap.add_argument("--force", action="store_true", help="ignore the cache")
+    ap.add_argument("--timeout", type=int, default=600)
+    args = ap.parse_args()
+
+    objdir = os.path.dirname(os.path.abspath(args.makefile))
+    objs = {}
+    for name in makefile_objs(args.makefile):
+        path = os.path.join(objdir, name)
+        objs[path] = ElfObject(path)
+    main_obj = objs.get(os.path.join(objdir, "main.o"))
+    if main_obj is None:
+        sys.exit("main.o is not in OBJS")
+    emu_hash = file_digest(args.emu)
+
+    benches = args.bench or [parse_bench(k) for k in KERNEL_DRIVERS]
+    cache = {} if args.force else load_json(args.cache)
+    baseline = load_json(args.baseline)
+    new_cache, results, bad = {}, [], False
+
+    for bid, kernel, bargs in benches:
+        key, deps = bench_key(objs, main_obj, KERNEL_DRIVERS[kernel], bargs, emu_hash)
+        hit = cache.get(bid)
+        if hit and hit.get("key") == key:
+            output, source = hit["output"], "cached"
+        else:
+            try:
+                proc = subprocess.run([args.emu, args.elf] + bargs, capture_output=True,
+                                      text=True, timeout=args.timeout)
+                output = proc.stdout
+                source = "ran" if proc.returncode == 0 else "exit %d" % proc.returncode
+            except subprocess.TimeoutExpired:
+                output, source = "", "timeout"
+        entry = dict(summarize(output), key=key, output=output, deps=deps)
+        if source in ("ran", "cached"):
+            new_cache[bid] = entry
+        bad |= source not in ("ran", "cached") or entry["failed"] > 0
+        results.append((bid, source, entry))
+
+    # keep cached entries of benchmarks not run this time
+    for bid, entry in cache.items():
+        new_cache.setdefault(bid, entry)
+    with open(args.cache, "w") as f:
+        json.dump(new_cache, f, indent=1, sort_keys=True)
+
+    hdr = "%-26s %-7s %12s %12s %4s %4s %12s %8s"
+    print(hdr % ("benchmark", "source", "cycles", "instret", "pass", "fail", "baseline", "delta"))
+    for bid, source, e in results:
+        base = baseline.get(bid, {}).get("cycles")
+        delta = ("%+7.2f%%" % ((e["cycles"] - base) * 100.0 / base)
+                 if base and e["cycles"] is not None else "")
+        print(hdr % (bid, source, e["cycles"] if e["cycles"] is not None else "-",
+                     e["instret"] if e["instret"] is not None else "-",
+                     e["passed"], e["failed"], base if base else "-", delta))
+    reran = sum(1 for r in results if r[1] != "cached")
+    print("%d benchmarks, %d run, %d from cache" % (len(results), reran, len(results) - reran))
+
+    if args.output:
+        with open(args.output, "w") as f:
+            for bid, source, e in results:
+                f.write("### %s (%s; %s)\n%s\n" % (bid, source, ", ".join(e["deps"]), e["output"]))
+    if args.save_baseline:
+        with open(args.save_baseline, "w") as f:
+            json.dump({bid: {"cycles": e["cycles"], "instret": e["instret"]}
+                       for bid, _, e in results}, f, indent=1, sort_keys=True)
+    sys.exit(1 if bad else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,102 @@
+"""Sections, symbols and relocations of relocatable ELF files, shared by
+benchrun.py, loopcost.py and tracedecode.py."""
+
+import struct
+
+SHT_SYMTAB, SHT_RELA, SHT_NOBITS, SHT_REL = 2, 4, 8, 9
+SHF_ALLOC, SHF_EXECINSTR, SHF_STRINGS = 0x2, 0x4, 0x20
+SHN_UNDEF = 0
+STB_LOCAL = 0
+STT_NOTYPE, STT_OBJECT, STT_FUNC = 0, 1, 2
+
+
+class Symbol:
+    def __init__(self, name, value, size, info, shndx):
+        self.name = name
+        self.value = value
+        self.size = size
+        self.type = info & 0xF
+        self.bind = info >> 4
+        self.shndx = shndx
+
+
+class ElfObject:
+    """Sections, symbols and relocations of a relocatable ELF file."""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            data = f.read()
+        if data[:4] != b"\x7fELF":
+            raise ValueError("%s: not an ELF file" % path)
+        self.path = path
+        self.data = data
+        is64 = data[4] == 2
+        e = "<" if data[5] == 1 else ">"
+        if is64:
+            shoff, = struct.unpack_from(e + "Q", data, 0x28)
+            shentsize, shnum, shstrndx = struct.unpack_from(e + "HHH", data, 0x3A)
+            shfmt, symfmt, relfmt = e + "IIQQQQIIQQ", e + "IBBHQQ", e + "QQq"
+        else:
+            shoff, = struct.unpack_from(e + "I", data, 0x20)
+            shentsize, shnum, shstrndx = struct.unpack_from(e + "HHH", data, 0x2E)
+            shfmt, symfmt, relfmt = e + "IIIIIIIIII", e + "IIIBBH", e + "IIi"
+
+        # (name_off, type, flags, addr, offset, size, link, info, align, entsize)
+        self.sections = [struct.unpack_from(shfmt, data, shoff + i * shentsize)
+                         for i in range(shnum)]
+        shstr = self.sections[shstrndx]
+        self.names = [self._str(shstr, s[0]) for s in self.sections]
+
+        self.symbols = []
+        for sec in self.sections:
+            if sec[1] != SHT_SYMTAB:
+                continue
+            strtab = self.sections[sec[6]]
+            for off in range(sec[4], sec[4] + sec[5], sec[9]):
+                if is64:
+                    name, info, _, shndx, value, size = struct.unpack_from(symfmt, data, off)
+                else:
+                    name, value, size, info, _, shndx = struct.unpack_from(symfmt, data, off)
+                self.symbols.append(Symbol(self._str(strtab, name), value, size, info, shndx))
+
+        # target section index -> [(offset, type, symbol index, addend)]
+        self.relocs = {}
+        for sec in self.sections:
+            if sec[1] not in (SHT_RELA, SHT_REL):
+                continue
+            step = sec[9]
+            for off in range(sec[4], sec[4] + sec[5], step):
+                if sec[1] == SHT_RELA:
+                    r_off, r_info, addend = struct.unpack_from(relfmt, data, off)
+                else:
+                    r_off, r_info = struct.unpack_from(relfmt[:3], data, off)
+                    addend = 0
+                sym, typ = (r_info >> 32, r_info & 0xFFFFFFFF) if is64 else (r_info >> 8, r_info & 0xFF)
+                self.relocs.setdefault(sec[7], []).append((r_off, typ, sym, addend))
+
+    def _str(self, strsec, off):
+        start = strsec[4] + off
+        return self.data[start:self.data.index(b"\0", start)].decode()
+
+    def contents(self, shndx, start, size):
+        sec = self.sections[shndx]
+        if sec[1] == SHT_NOBITS:
+            return b"nobits:%d" % size
+        return self.data[sec[4] + start:sec[4] + start + size]
+
+    def defined(self):
+        return {s.name for s in self.symbols
+                if s.shndx != SHN_UNDEF and s.name and s.bind != STB_LOCAL}
+
+    def undefined(self):
+        return {s.name for s in self.symbols if s.shndx == SHN_UNDEF and s.name}
+
+    def alloc_digest(self, h):
+        """Allocated sections and their relocations, without debug info."""
+        for i, sec in enumerate(self.sections):
+            if not sec[2] & SHF_ALLOC:
+                continue
+            h.update(self.names[i].encode() + b"\0")
+            h.update(self.contents(i, 0, sec[5]))
+            for off, typ, sym, addend in self.relocs.get(i, []):
+                h.update(b"%d:%d:%s:%d;" % (off, typ, self.symbols[sym].name.encode(), addend))
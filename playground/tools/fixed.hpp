@@ -0,0 +1,179 @@
+#ifndef RV_FIXED_HPP
+#define RV_FIXED_HPP
+
+/* ---------------- Header-only unsigned fixed point, guest-exact ----------------
+ * rvfx::fixed<Frac> is an unsigned Q(32-Frac).Frac value in a uint32_t. Every
+ * operation is constexpr, so lookup tables and golden outputs can be built by
+ * the compiler instead of being pasted from guest runs.
+ *
+ * With Frac == 16 and Newton == 1 the results are bit-identical to the guest:
+ *   fixed<16>::rsqrt(x)    == fast_rsqrt(x)
+ *   fixed<16>::sqrt(x)     == x * fast_rsqrt(x)          (32-bit wrap)
+ *   a * b                  == mul32x16_shr16(a, b)        (b < 1.0)
+ * (quiz3_fast_reciprocal_square_root_Optimal.c). The guest splits every
+ * product into 16x16 pieces; those pieces sum to the exact floor of the
+ * full product, so one 64-bit multiply gives the same bits here.
+ *
+ * Other Frac values scale the same algorithm: LUT of 2^Frac / sqrt(2^i),
+ * 16-bit interpolation fraction, Newton steps in Q(Frac). rsqrt needs
+ * Frac <= 16 so that x * y^2 fits 64 bits.
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace rvfx {
+
+namespace detail {
+
+constexpr unsigned clz32(std::uint32_t x)
+{
+    if (!x) return 32u;
+    unsigned n = 0;
+    while (!(x & 0x80000000u)) { x <<= 1; n++; }
+    return n;
+}
+
+/* floor(sqrt(v)) by bisection; only used while building tables */
+constexpr std::uint64_t isqrt64(std::uint64_t v)
+{
+    std::uint64_t lo = 0, hi = 0xFFFFFFFFu;
+    while (lo < hi) {
+        std::uint64_t mid = lo + (hi - lo + 1) / 2;
+        if (mid <= v / mid) lo = mid;
+        else hi = mid - 1;
+    }
+    return lo;
+}
+
+/* The guest table: 2^16 / sqrt(2^i) rounded, entry 0 clamped to 0xFFFF.
+ * Entry 19 is 90 although 2^6.5 = 90.51 rounds to 91, so Q16 uses the
+ * guest values verbatim instead of regenerating them. */
+constexpr std::uint16_t guest_rsqrt_table[32] = {
+    65535, 46341, 32768, 23170, 16384,
+    11585,  8192,  5793,  4096,  2896,
+     2048,  1448,  1024,   724,   512,
+      362,   256,   181,   128,    90,
+       64,    45,    32,    23,    16,
+       11,     8,     6,     4,     3,
+        2,     1
+};
+
+/* round(2^Frac / sqrt(2^i)) = round(sqrt(2^(2*Frac - i))), kept in [1, 2^Frac - 1] */
+constexpr std::uint32_t rsqrt_lut_entry(unsigned frac, unsigned i)
+{
+    if (frac == 16u) return guest_rsqrt_table[i];
+    std::uint32_t max = (1u << frac) - 1u;
+    if (i > 2u * frac + 1u) return 1u;
+    /* round(sqrt(v)) == (floor(sqrt(4v)) + 1) / 2; 2*Frac - i + 2 >= 0 here */
+    std::uint64_t r = (isqrt64(std::uint64_t(1) << (2u * frac - i + 2u)) + 1u) / 2u;
+    if (r > max) r = max;
+    if (r < 1u) r = 1u;
+    return std::uint32_t(r);
+}
+
+} // namespace detail
+
+template <unsigned Frac>
+class fixed {
+    static_assert(Frac >= 1u && Frac <= 31u, "fixed<Frac>: Frac must be in [1, 31]");
+
+public:
+    using raw_type = std::uint32_t;
+    static constexpr unsigned frac_bits = Frac;
+    static constexpr raw_type frac_mask = (raw_type(1) << Frac) - 1u;
+
+    constexpr fixed() = default;
+
+    static constexpr fixed from_raw(raw_type r) { fixed f; f.v_ = r; return f; }
+    static constexpr fixed from_int(std::uint32_t i) { return from_raw(i << Frac); }
+
+    constexpr raw_type raw() const { return v_; }
+    constexpr std::uint32_t int_part() const { return v_ >> Frac; }
+    constexpr raw_type frac_part() const { return v_ & frac_mask; }
+    constexpr double to_double() const { return double(v_) / double(std::uint64_t(1) << Frac); }
+
+    /* Wrapping add/sub like the guest's 32-bit registers */
+    friend constexpr fixed operator+(fixed a, fixed b) { return from_raw(a.v_ + b.v_); }
+    friend constexpr fixed operator-(fixed a, fixed b) { return from_raw(a.v_ - b.v_); }
+
+    /* floor(a * b) in Q(Frac), truncated to 32 bits */
+    friend constexpr fixed operator*(fixed a, fixed b)
+    {
+        return from_raw(raw_type((std::uint64_t(a.v_) * b.v_) >> Frac));
+    }
+
+    friend constexpr bool operator==(fixed a, fixed b) { return a.v_ == b.v_; }
+    friend constexpr bool operator!=(fixed a, fixed b) { return a.v_ != b.v_; }
+    friend constexpr bool operator<(fixed a, fixed b)  { return a.v_ < b.v_; }
+    friend constexpr bool operator>(fixed a, fixed b)  { return a.v_ > b.v_; }
+    friend constexpr bool operator<=(fixed a, fixed b) { return a.v_ <= b.v_; }
+    friend constexpr bool operator>=(fixed a, fixed b) { return a.v_ >= b.v_; }
+
+    /* y0 for bucket e = 31 - clz(x); entry 32 is the e == 31 upper neighbour */
+    static constexpr std::array<raw_type, 33> rsqrt_lut()
+    {
+        static_assert(Frac <= 16u, "rsqrt_lut: entries are built in 64 bits");
+        std::array<raw_type, 33> t{};
+        for (unsigned i = 0; i < 32u; i++) t[i] = detail::rsqrt_lut_entry(Frac, i);
+        t[32] = 1u;
+        return t;
+    }
+
+    /* y <- y * (3 - x*y^2) / 2, with the guest's 16-bit term split */
+    static constexpr raw_type newton_step(raw_type y, std::uint32_t x)
+    {
+        static_assert(Frac <= 16u, "rsqrt: x * y^2 must fit 64 bits");
+        y &= frac_mask;
+        std::uint64_t y2 = std::uint64_t(y) * y;
+        raw_type xy2 = raw_type((std::uint64_t(x) * y2) >> Frac);
+        raw_type term = (raw_type(3) << Frac) - xy2;
+        raw_type term_hi = term >> Frac;
+        raw_type term_lo = term & frac_mask;
+        raw_type y_mul_hi = term_hi <= 3u ? y * term_hi : 0u;
+        return (y_mul_hi >> 1) + raw_type((std::uint64_t(y) * term_lo) >> (Frac + 1u));
+    }
+
+    /* 1/sqrt(x) for integer x: LUT, linear interpolation, Newton steps.
+     * rsqrt(0) == 0 as in the guest. */
+    template <unsigned Newton = 1>
+    static constexpr fixed rsqrt(std::uint32_t x)
+    {
+        if (x == 0u) return from_raw(0u);
+        constexpr std::array<raw_type, 33> lut = rsqrt_lut();
+        unsigned e = 31u - detail::clz32(x);
+        raw_type y0 = lut[e], y1 = lut[e + 1u];
+        raw_type diff = x - (raw_type(1) << e);
+        raw_type frac = e >= 16u ? diff >> (e - 16u) : diff << (16u - e);
+        raw_type y = y0 - raw_type((std::uint64_t(y0 - y1) * frac) >> 16);
+        for (unsigned i = 0; i < Newton; i++) y = newton_step(y, x);
+        return from_raw(y);
+    }
+
+    /* sqrt(x) = x * rsqrt(x); raw product wraps at 32 bits like the guest's */
+    template <unsigned Newton = 1>
+    static constexpr fixed sqrt(std::uint32_t x)
+    {
+        return from_raw(x * rsqrt<Newton>(x).raw());
+    }
+
+private:
+    raw_type v_ = 0;
+};
+
+using q16 = fixed<16>;
+
+/* std::array of f(0) .. f(N-1), evaluated at compile time when used in a
+ * constexpr context:  constexpr auto t = rvfx::make_table<64>(fn); */
+template <std::size_t N, class F>
+constexpr auto make_table(F f) -> std::array<decltype(f(std::uint32_t(0))), N>
+{
+    std::array<decltype(f(std::uint32_t(0))), N> t{};
+    for (std::size_t i = 0; i < N; i++) t[i] = f(std::uint32_t(i));
+    return t;
+}
+
+} // namespace rvfx
+
+#endif /* RV_FIXED_HPP */
@@ -0,0 +1,128 @@
+/* fixed_golden: compile-time fast_rsqrt tables from fixed.hpp, checked
+ * against the guest C at build time (static_assert) and at run time.
+ *
+ *   fixed_golden [--emit]
+ *
+ * Without arguments, compares rvfx::q16 rsqrt/sqrt/mul with the guest
+ * references over every input below 2^24, +-64 around every power of two
+ * and 2^22 pseudo-random inputs; sqrt is also checked against an exact
+ * integer square root with a stated tolerance. --emit prints the golden
+ * tables as C.
+ */
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+
+#include "fixed.hpp"
+#include "rvcodec.h"
+
+using rvfx::q16;
+
+/* Inputs of test_Fast_rsqrt in main.c */
+static constexpr std::uint32_t test_inputs[] = {
+    1, 2, 4, 5, 10, 16, 20, 100, 1000, 0xFFFFFFFFu
+};
+static constexpr std::size_t n_tests = sizeof(test_inputs) / sizeof(test_inputs[0]);
+
+static constexpr auto golden = rvfx::make_table<n_tests>(
+    [](std::uint32_t i) { return q16::rsqrt(test_inputs[i]).raw(); });
+
+/* Recorded from the guest; the compiler re-derives them on every build */
+static_assert(golden[0] == 65535 && golden[1] == 46341 && golden[2] == 32768, "");
+static_assert(golden[3] == 29249 && golden[4] == 20683 && golden[5] == 16384, "");
+static_assert(golden[6] == 14624 && golden[7] == 6533 && golden[8] == 2072, "");
+static_assert(golden[9] == 1, "");
+static_assert(q16::rsqrt(0).raw() == 0, "");
+
+/* fast_rsqrt(0..255), the range the uf8 normalization path feeds */
+static constexpr auto rsqrt_0_255 = rvfx::make_table<256>(
+    [](std::uint32_t x) { return q16::rsqrt(x).raw(); });
+
+static unsigned long mismatches;
+
+static void report(const char *fn, std::uint32_t in, std::uint32_t got, std::uint32_t exp)
+{
+    if (mismatches++ < 8)
+        std::printf("    %s(0x%08" PRIx32 "): got 0x%08" PRIx32 ", expected 0x%08" PRIx32 "\n",
+                    fn, in, got, exp);
+}
+
+static std::uint32_t xorshift32(std::uint32_t *s)
+{
+    *s ^= *s << 13;
+    *s ^= *s >> 17;
+    *s ^= *s << 5;
+    return *s;
+}
+
+static void check(std::uint32_t x, std::uint32_t other)
+{
+    std::uint32_t ref = rvc_rsqrt_q16_ref(x);
+    std::uint32_t got = q16::rsqrt(x).raw();
+    if (got != ref) report("rsqrt", x, got, ref);
+
+    /* Bit-exact with the guest's x * fast_rsqrt(x), and within tolerance of
+     * floor(sqrt(x) * 2^16) = isqrt(x << 32): 1/256 of the value (rsqrt's
+     * interpolation error peaks near 0.31% at x = 12) plus 2x (two rsqrt
+     * LSBs, each worth x in the product). Measured worst-case slack over
+     * these inputs: 0.0031 of the value with 2x, no product above 2^32. */
+    got = q16::sqrt(x).raw();
+    if (got != x * ref) report("sqrt(guest)", x, got, x * ref);
+    std::uint64_t exact = rvfx::detail::isqrt64(std::uint64_t(x) << 32);
+    std::uint64_t err = got > exact ? got - exact : exact - got;
+    if (err > exact / 256u + 2u * std::uint64_t(x))
+        report("sqrt(isqrt)", x, got, std::uint32_t(exact));
+
+    std::uint32_t y16 = other & 0xFFFFu;
+    ref = rvc_mul32x16_shr16_ref(x, y16);
+    got = (q16::from_raw(x) * q16::from_raw(y16)).raw();
+    if (got != ref) report("mul", x, got, ref);
+}
+
+static bool verify(void)
+{
+    mismatches = 0;
+    for (std::size_t i = 0; i < 256; i++)
+        if (rsqrt_0_255[i] != rvc_rsqrt_q16_ref(std::uint32_t(i)))
+            report("rsqrt_0_255", std::uint32_t(i), rsqrt_0_255[i],
+                   rvc_rsqrt_q16_ref(std::uint32_t(i)));
+
+    std::uint32_t seed = 0x2545F491u;
+    for (std::uint32_t x = 0; x < (1u << 24); x++)
+        check(x, xorshift32(&seed));
+    for (unsigned e = 0; e < 32; e++)
+        for (int d = -64; d <= 64; d++)
+            check((1u << e) + std::uint32_t(d), xorshift32(&seed));
+    for (std::uint32_t i = 0; i < (1u << 22); i++) {
+        std::uint32_t x = xorshift32(&seed);
+        check(x, xorshift32(&seed));
+    }
+    return mismatches == 0;
+}
+
+static void emit_table(const char *name, const std::uint32_t *t, std::size_t n)
+{
+    std::printf("static const uint32_t %s[%zu] = {", name, n);
+    for (std::size_t i = 0; i < n; i++)
+        std::printf("%s%" PRIu32 ",", (i % 8) ? " " : "\n    ", t[i]);
+    std::printf("\n};\n");
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 && !std::strcmp(argv[1], "--emit")) {
+        std::printf("/* generated by tools/fixed_golden --emit */\n");
+        emit_table("fast_rsqrt_golden", golden.data(), golden.size());
+        emit_table("fast_rsqrt_0_255", rsqrt_0_255.data(), rsqrt_0_255.size());
+        return 0;
+    }
+    if (argc > 1) {
+        std::fprintf(stderr, "usage: %s [--emit]\n", argv[0]);
+        return 2;
+    }
+
+    std::printf("fixed<16> vs guest fast_rsqrt / mul32x16_shr16\n");
+    bool ok = verify();
+    std::printf("  %s\n", ok ? "PASSED" : "FAILED");
+    return ok ? 0 : 1;
+}
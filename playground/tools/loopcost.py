@@ -0,0 +1,361 @@
+#!/usr/bin/env python3
+"""Static per-loop cost report for test.elf, built from objdump output.
+
+    $(OBJDUMP) -d test.elf | tools/loopcost.py [--elf test.elf] [--costs FILE]
+                                               [--measured FILE]
+    tools/loopcost.py --self-test
+
+A loop is a backward branch or jump inside the text section; its body is
+every instruction from the branch target up to and including the branch.
+For each loop the report gives instructions, loads, stores, conditional
+branches, jumps, calls and ecalls per iteration, the branches that are taken
+on the straight-line path (unconditional jumps plus the back edge) and a
+cycle estimate from a per-class cost table.
+
+--costs FILE     "class=cycles" lines (alu, load, store, branch,
+                 branch_taken, jump, call, ecall, csr); missing classes
+                 cost 1 cycle, branch_taken is extra on top of branch.
+                 `make costs` measures one (test.elf --kernel=platform).
+--measured FILE  guest output of `test.elf --sweep`; rows are matched to
+                 the kernel's entry symbol and printed next to its loops.
+--elf FILE       the ELF that was disassembled. objdump -d lists local asm
+                 labels (quiz1_uf8.S's enCode_up_loop, ...) like functions;
+                 with the symbol table, local symbols that are not
+                 STT_FUNC are folded into the function before them, so
+                 uf8_encode owns its loops. Without it every label counts
+                 as a function.
+--self-test      check the report on a built-in objdump fixture.
+
+Accepts both GNU and LLVM objdump syntax, with or without raw bytes.
+"""
+
+import argparse
+import re
+import sys
+
+from elfobj import ElfObject, STB_LOCAL, STT_NOTYPE
+
+LOADS = {"lb", "lh", "lw", "lbu", "lhu"}
+STORES = {"sb", "sh", "sw"}
+COND_BRANCHES = {
+    "beq", "bne", "blt", "bge", "bltu", "bgeu",
+    "beqz", "bnez", "blez", "bgez", "bltz", "bgtz",
+    "bgt", "ble", "bgtu", "bleu",
+}
+JUMPS = {"j", "jal", "jr", "jalr", "call", "tail", "ret"}
+CSRS = {
+    "csrr", "csrw", "csrs", "csrc", "csrrw", "csrrs", "csrrc",
+    "csrwi", "csrsi", "csrci", "csrrwi", "csrrsi", "csrrci",
+    "rdcycle", "rdcycleh", "rdinstret", "rdinstreth", "rdtime", "rdtimeh",
+}
+COST_CLASSES = ("alu", "load", "store", "branch", "branch_taken",
+                "jump", "call", "ecall", "csr")
+
+# sweep kernel name -> entry symbol
+KERNEL_SYMBOLS = {
+    "uf8": "uf8_encode",
+    "rsqrt": "fast_rsqrt",
+    "chacha20": "chacha20",
+    "pipeline": "pipeline_run",
+}
+
+SYMBOL_RE = re.compile(r"^([0-9a-fA-F]+)\s+<([^>]+)>:\s*$")
+INSN_RE = re.compile(r"^\s*([0-9a-fA-F]+):\s?(.*)$")
+# GNU prints raw bytes as one 4/8-digit word, LLVM as spaced byte pairs;
+# both must not swallow hex-looking mnemonics such as "add".
+RAW_RE = re.compile(r"^(?:[0-9a-fA-F]{8}|[0-9a-fA-F]{4}|[0-9a-fA-F]{2}(?: [0-9a-fA-F]{2})+)$")
+
+TARGET_RE = re.compile(r"(?:^|[\s,])(?:0x)?([0-9a-fA-F]+)\s+<")
+
+
+class Insn:
+    def __init__(self, addr, mnem, ops):
+        self.addr = addr
+        self.mnem = mnem
+        self.ops = ops
+        m = TARGET_RE.search(ops)
+        self.target = int(m.group(1), 16) if m else None
+
+    @property
+    def is_call(self):
+        if self.mnem == "call":
+            return True
+        if self.mnem in ("jal", "jalr"):
+            regs = [o.strip() for o in self.ops.split("<")[0].split(",")]
+            # "jal <addr>" / "jalr rs" link through ra implicitly
+            return len(regs) == 1 or regs[0] in ("ra", "x1")
+        return False
+
+    def cls(self):
+        if self.mnem in LOADS:
+            return "load"
+        if self.mnem in STORES:
+            return "store"
+        if self.mnem in COND_BRANCHES:
+            return "branch"
+        if self.is_call:
+            return "call"
+        if self.mnem in JUMPS:
+            return "jump"
+        if self.mnem == "ecall":
+            return "ecall"
+        if self.mnem in CSRS:
+            return "csr"
+        return "alu"
+
+
+def parse_objdump(lines):
+    """Return (instructions in address order, {addr: symbol})."""
+    insns, symbols = [], {}
+    in_text = False
+    for line in lines:
+        line = line.rstrip("\n")
+        if line.startswith("Disassembly of section"):
+            in_text = line.rstrip(":").endswith(".text")
+            continue
+        if not in_text:
+            continue
+        m = SYMBOL_RE.match(line)
+        if m:
+            symbols[int(m.group(1), 16)] = m.group(2)
+            continue
+        m = INSN_RE.match(line)
+        if not m:
+            continue
+        fields = [f.strip() for f in m.group(2).split("\t") if f.strip()]
+        if len(fields) > 1 and RAW_RE.match(fields[0]):
+            fields = fields[1:]
+        if not fields:
+            continue
+        parts = fields[0].split(None, 1)
+        mnem = parts[0]
+        ops = " ".join(parts[1:] + fields[1:])
+        insns.append(Insn(int(m.group(1), 16), mnem, ops))
+    return insns, symbols
+
+
+def symbol_at(addr, sym_addrs, symbols):
+    best = None
+    for a in sym_addrs:
+        if a > addr:
+            break
+        best = a
+    if best is None:
+        return "?"
+    return symbols[best] if best == addr else "%s+0x%x" % (symbols[best], addr - best)
+
+
+def function_of(addr, func_addrs, symbols):
+    best = None
+    for a in func_addrs:
+        if a > addr:
+            break
+        best = a
+    return symbols.get(best, "?")
+
+
+def read_labels(path):
+    """Local untyped symbols of an ELF: asm labels inside a function."""
+    return {s.name for s in ElfObject(path).symbols
+            if s.name and s.bind == STB_LOCAL and s.type == STT_NOTYPE}
+
+
+def find_loops(insns, symbols, labels=frozenset()):
+    index = {ins.addr: i for i, ins in enumerate(insns)}
+    sym_addrs = sorted(symbols)
+    func_addrs = [a for a in sym_addrs if symbols[a] not in labels]
+    loops = []
+    for i, ins in enumerate(insns):
+        if ins.target is None or ins.target > ins.addr or ins.is_call:
+            continue
+        if ins.cls() not in ("branch", "jump") or ins.target not in index:
+            continue
+        body = insns[index[ins.target]:i + 1]
+        loops.append({
+            "head": symbol_at(ins.target, sym_addrs, symbols),
+            "func": function_of(ins.addr, func_addrs, symbols),
+            "start": ins.target,
+            "end": ins.addr,
+            "body": body,
+        })
+    for lp in loops:
+        lp["depth"] = sum(1 for o in loops if o is not lp and
+                          o["start"] <= lp["start"] and lp["end"] <= o["end"])
+    return loops
+
+
+def loop_stats(lp, costs):
+    counts = dict.fromkeys(COST_CLASSES, 0)
+    for ins in lp["body"]:
+        counts[ins.cls()] += 1
+    backedge = lp["body"][-1]
+    # straight-line path: every jump and the back edge are taken
+    taken = counts["jump"] + counts["call"]
+    if backedge.cls() == "branch":
+        taken += 1
+    est = sum(counts[c] * costs[c] for c in COST_CLASSES if c != "branch_taken")
+    est += taken * costs["branch_taken"]
+    counts["insns"] = len(lp["body"])
+    counts["taken"] = taken
+    counts["est"] = est
+    return counts
+
+
+def read_costs(path):
+    costs = dict.fromkeys(COST_CLASSES, 1.0)
+    costs["branch_taken"] = 0.0
+    if not path:
+        return costs
+    with open(path) as f:
+        for line in f:
+            line = line.split("#", 1)[0].strip()
+            if not line:
+                continue
+            key, _, val = line.partition("=")
+            key = key.strip()
+            if key not in costs:
+                sys.exit("%s: unknown cost class '%s'" % (path, key))
+            costs[key] = float(val)
+    return costs
+
+
+def parse_measured(lines):
+    """kernel -> [(size, exp, align, units, cycles)] from --sweep output."""
+    rows = {}
+    for line in lines:
+        cols = line.strip().split(",")
+        if len(cols) != 7 or cols[0] not in KERNEL_SYMBOLS:
+            continue
+        try:
+            vals = [int(c) for c in cols[1:6]]
+        except ValueError:
+            continue
+        rows.setdefault(cols[0], []).append(tuple(vals))
+    return rows
+
+
+def read_measured(path):
+    if not path:
+        return {}
+    with open(path) as f:
+        return parse_measured(f)
+
+
+def report(insns, symbols, labels, costs, measured, funcs=None):
+    """The report as a list of lines."""
+    loops = find_loops(insns, symbols, labels)
+    if funcs:
+        loops = [lp for lp in loops if lp["func"] in funcs]
+
+    hdr = "%-22s %-28s %-17s %5s %5s %5s %5s %5s %5s %5s %5s %5s %8s"
+    row = "%-22s %-28s %08x-%08x %5d %5d %5d %5d %5d %5d %5d %5d %5d %8.1f"
+    out = [hdr % ("function", "loop head", "range", "depth", "insns", "loads",
+                  "stors", "cbr", "jumps", "calls", "ecall", "taken", "est.cyc")]
+    per_func = {}
+    for lp in loops:
+        st = loop_stats(lp, costs)
+        per_func.setdefault(lp["func"], []).append(st)
+        out.append(row % (lp["func"][:22], lp["head"][:28], lp["start"], lp["end"],
+                          lp["depth"], st["insns"], st["load"], st["store"],
+                          st["branch"], st["jump"], st["call"], st["ecall"],
+                          st["taken"], st["est"]))
+
+    if not measured:
+        return out
+    out.append("")
+    out.append("measured (cycles/unit from --sweep) vs. static loop estimates")
+    for kernel, rows in measured.items():
+        sym = KERNEL_SYMBOLS[kernel]
+        ests = per_func.get(sym, [])
+        est_txt = ", ".join("%.0f" % s["est"] for s in ests) or "no loops"
+        out.append("%s (%s): loop est.cyc/iter = %s" % (kernel, sym, est_txt))
+        for size, exp, align, units, cycles in rows:
+            cpu = cycles / units if units else float(cycles)
+            out.append("    size=%-6d exp=%-2d align=%-2d cycles=%-9d cycles/unit=%.2f"
+                       % (size, exp, align, cycles, cpu))
+    return out
+
+
+# uf8_encode as GNU objdump prints it: its loop sits under the local labels
+# enCode_up_loop / enCode_up_done, which only --elf tells apart from functions
+SELF_TEST_DUMP = """
+Disassembly of section .text:
+
+00010100 <uf8_encode>:
+   10100:\t00100793          \tli\ta5,1
+   10104:\t00f50463          \tbeq\ta0,a5,1010c <enCode_normalVal>
+
+00010108 <enCode_find_up>:
+   10108:\t00f00e93          \tli\tt4,15
+
+0001010c <enCode_up_loop>:
+   1010c:\t01d45a63          \tbge\ts0,t4,10120 <enCode_up_done>
+   10110:\t00149313          \tslli\tt1,s1,0x1
+   10114:\t01030313          \taddi\tt1,t1,16
+   10118:\t00140413          \taddi\ts0,s0,1
+   1011c:\tff1ff06f          \tj\t1010c <enCode_up_loop>
+
+00010120 <enCode_up_done>:
+   10120:\t00008067          \tret
+
+00010124 <fast_rsqrt>:
+   10124:\tfff50513          \taddi\ta0,a0,-1
+   10128:\tfe051ee3          \tbnez\ta0,10124 <fast_rsqrt>
+   1012c:\t00008067          \tret
+"""
+SELF_TEST_LABELS = {"enCode_normalVal", "enCode_find_up", "enCode_up_loop", "enCode_up_done"}
+SELF_TEST_SWEEP = ["kernel,size,exp,align,units,cycles,cycles_per_unit",
+                   "uf8,64,5,0,64,2048,32.00",
+                   "rsqrt,64,5,0,64,1024,16.00"]
+
+
+def self_test():
+    insns, symbols = parse_objdump(SELF_TEST_DUMP.splitlines())
+    costs = read_costs(None)
+    measured = parse_measured(SELF_TEST_SWEEP)
+    ok = True
+
+    def check(what, cond):
+        nonlocal ok
+        print("%-60s %s" % (what, "ok" if cond else "FAILED"))
+        ok &= cond
+
+    lines = report(insns, symbols, SELF_TEST_LABELS, costs, measured)
+    text = "\n".join(lines)
+    check("uf8_encode owns the enCode_up_loop loop",
+          any(l.startswith("uf8_encode ") and "enCode_up_loop" in l for l in lines))
+    check("uf8 gets a loop est.cyc/iter", "uf8 (uf8_encode): loop est.cyc/iter = 5" in text)
+    check("rsqrt gets a loop est.cyc/iter", "rsqrt (fast_rsqrt): loop est.cyc/iter = 2" in text)
+    check("no kernel reports 'no loops'", "no loops" not in text)
+    bare = "\n".join(report(insns, symbols, frozenset(), costs, measured))
+    check("without labels the loop lands under its label",
+          "uf8 (uf8_encode): loop est.cyc/iter = no loops" in bare)
+    return ok
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    ap.add_argument("dump", nargs="?", help="objdump -d output (default: stdin)")
+    ap.add_argument("--elf", help="disassembled ELF, for its symbol table")
+    ap.add_argument("--costs", help="per-class cycle costs")
+    ap.add_argument("--measured", help="test.elf --sweep output")
+    ap.add_argument("--func", action="append",
+                    help="only report loops in this function (repeatable)")
+    ap.add_argument("--self-test", action="store_true", help="check the built-in fixture")
+    args = ap.parse_args()
+
+    if args.self_test:
+        sys.exit(0 if self_test() else 1)
+
+    src = open(args.dump) if args.dump else sys.stdin
+    insns, symbols = parse_objdump(src)
+    if not insns:
+        sys.exit("no .text instructions found in objdump output")
+    labels = read_labels(args.elf) if args.elf else frozenset()
+    for line in report(insns, symbols, labels, read_costs(args.costs),
+                       read_measured(args.measured), args.func):
+        print(line)
+
+
+if __name__ == "__main__":
+    main()
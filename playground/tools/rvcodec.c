@@ -0,0 +1,154 @@
+#include <string.h>
+
+#include "rvcodec.h"
+#include "rvcodec_impl.h"
+
+/* The guest source is portable C: compile it here so the reference is the
+ * guest algorithm itself (clz32, mul16x16_32, rsqrt_table, Newton step). */
+#define fast_rsqrt rvc_guest_fast_rsqrt
+#include "../quiz3_fast_reciprocal_square_root_Optimal.c"
+#undef fast_rsqrt
+
+uint32_t rvc_rsqrt_y0[33];
+uint32_t rvc_rsqrt_y1[33];
+
+/* ---------------- Scalar references ---------------- */
+/* Line-by-line port of uf8_encode in quiz1_uf8.S */
+uint8_t rvc_uf8_encode_ref(uint32_t value)
+{
+    if (value < 16u) return (uint8_t)value;
+
+    uint32_t msb = 31u - clz32(value);
+    uint32_t exponent = 0, overflow = 0;
+
+    if (msb >= 5u) {
+        exponent = msb - 4u;
+        if (exponent > 15u) exponent = 15u;
+        for (uint32_t e = 0; e < exponent; e++)
+            overflow = (overflow << 1) + 16u;
+        while (exponent > 0u && value < overflow) {
+            overflow = (overflow - 16u) >> 1;
+            exponent--;
+        }
+    }
+    while (exponent < 15u) {
+        uint32_t next = (overflow << 1) + 16u;
+        if (value < next) break;
+        overflow = next;
+        exponent++;
+    }
+    return (uint8_t)((exponent << 4) | (((value - overflow) >> exponent) & 0x0Fu));
+}
+
+uint32_t rvc_uf8_decode_ref(uint8_t code)
+{
+    uint32_t m = code & 0x0Fu;
+    uint32_t e = code >> 4;
+    return (m << e) + (((1u << e) - 1u) << 4);
+}
+
+uint32_t rvc_rsqrt_q16_ref(uint32_t x)
+{
+    return rvc_guest_fast_rsqrt(x);
+}
+
+uint32_t rvc_mul32x16_shr16_ref(uint32_t x32, uint32_t y16)
+{
+    return mul32x16_shr16(x32, y16);
+}
+
+/* ---------------- Scalar batch ---------------- */
+static void uf8_encode_scalar(uint8_t *dst, const uint32_t *src, size_t n)
+{
+    for (size_t i = 0; i < n; i++) dst[i] = rvc_uf8_encode_ref(src[i]);
+}
+
+static void uf8_decode_scalar(uint32_t *dst, const uint8_t *src, size_t n)
+{
+    for (size_t i = 0; i < n; i++) dst[i] = rvc_uf8_decode_ref(src[i]);
+}
+
+static void rsqrt_q16_scalar(uint32_t *dst, const uint32_t *src, size_t n)
+{
+    for (size_t i = 0; i < n; i++) dst[i] = rvc_guest_fast_rsqrt(src[i]);
+}
+
+static const rvc_impl rvc_impl_scalar = {
+    "scalar", uf8_encode_scalar, uf8_decode_scalar, rsqrt_q16_scalar
+};
+
+/* ---------------- Dispatch ---------------- */
+static const rvc_impl *active;
+
+static void init_tables(void)
+{
+    for (int n = 0; n < 33; n++) {
+        int e = 31 - n;
+        rvc_rsqrt_y0[n] = (e >= 0) ? rsqrt_table[e] : 0u;
+        rvc_rsqrt_y1[n] = (e >= 0 && e < 31) ? rsqrt_table[e + 1] : 1u;
+    }
+}
+
+static int cpu_has(const rvc_impl *impl)
+{
+    if (impl == &rvc_impl_scalar) return 1;
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (impl == &rvc_impl_avx2)  return __builtin_cpu_supports("avx2");
+    if (impl == &rvc_impl_sse41) return __builtin_cpu_supports("sse4.1");
+#elif defined(__aarch64__)
+    if (impl == &rvc_impl_neon) return 1;
+#endif
+    return 0;
+}
+
+/* Best first */
+static const rvc_impl *const impls[] = {
+#if defined(__x86_64__) || defined(__i386__)
+    &rvc_impl_avx2,
+    &rvc_impl_sse41,
+#elif defined(__aarch64__)
+    &rvc_impl_neon,
+#endif
+    &rvc_impl_scalar,
+};
+
+static const rvc_impl *get_impl(void)
+{
+    if (!active) {
+        init_tables();
+        for (size_t i = 0; i < sizeof(impls) / sizeof(impls[0]); i++) {
+            if (cpu_has(impls[i])) { active = impls[i]; break; }
+        }
+    }
+    return active;
+}
+
+int rvc_select_impl(const char *name)
+{
+    get_impl();
+    for (size_t i = 0; i < sizeof(impls) / sizeof(impls[0]); i++) {
+        if (strcmp(impls[i]->name, name) == 0 && cpu_has(impls[i])) {
+            active = impls[i];
+            return 1;
+        }
+    }
+    return 0;
+}
+
+const char *rvc_impl_name(void) { return get_impl()->name; }
+
+void rvc_uf8_encode(uint8_t *dst, const uint32_t *src, size_t n)
+{
+    get_impl()->uf8_encode(dst, src, n);
+}
+
+void rvc_uf8_decode(uint32_t *dst, const uint8_t *src, size_t n)
+{
+    get_impl()->uf8_decode(dst, src, n);
+}
+
+void rvc_rsqrt_q16(uint32_t *dst, const uint32_t *src, size_t n)
+{
+    get_impl()->rsqrt_q16(dst, src, n);
+}
@@ -0,0 +1,44 @@
+#ifndef RVCODEC_H
+#define RVCODEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* ---------------- Host batch codecs, bit-exact with the guest ----------------
+ * rvc_uf8_encode  == uf8_encode  (quiz1_uf8.S), including its mantissa wrap
+ *                    for values above uf8_decode(0xFF)
+ * rvc_uf8_decode  == uf8_decode  (quiz1_uf8.S)
+ * rvc_rsqrt_q16   == fast_rsqrt  (quiz3_fast_reciprocal_square_root_Optimal.c):
+ *                    LUT, interpolation and one Newton step with the same
+ *                    truncations
+ *
+ * The batch entry points pick AVX2, SSE4.1, NEON or scalar code on first use.
+ * The *_ref functions are one-value ports of the guest code and define the
+ * expected output.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void rvc_uf8_encode(uint8_t *dst, const uint32_t *src, size_t n);
+void rvc_uf8_decode(uint32_t *dst, const uint8_t *src, size_t n);
+void rvc_rsqrt_q16(uint32_t *dst, const uint32_t *src, size_t n);
+
+uint8_t  rvc_uf8_encode_ref(uint32_t value);
+uint32_t rvc_uf8_decode_ref(uint8_t code);
+uint32_t rvc_rsqrt_q16_ref(uint32_t x);
+uint32_t rvc_mul32x16_shr16_ref(uint32_t x32, uint32_t y16);
+
+/* Name of the active implementation ("avx2", "sse4.1", "neon", "scalar") */
+const char *rvc_impl_name(void);
+
+/* Force an implementation by name; returns 0 if it is not built in or the
+ * CPU lacks it. Used by rvcodec_bench to check every path. */
+int rvc_select_impl(const char *name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RVCODEC_H */
@@ -0,0 +1,123 @@
+/* AVX2 batch codecs; build with -mavx2, called only after dispatch */
+#include <immintrin.h>
+
+#include "rvcodec.h"
+#include "rvcodec_impl.h"
+
+/* Same steps as rvcodec_sse41.c on eight lanes; see the comments there. */
+static inline __m256i clz_norm(__m256i x, __m256i *xn)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i n = zero, m;
+
+#define CLZ_STEP(s)                                                     \
+    m = _mm256_cmpeq_epi32(_mm256_srli_epi32(x, 32 - (s)), zero);       \
+    x = _mm256_blendv_epi8(x, _mm256_slli_epi32(x, (s)), m);            \
+    n = _mm256_add_epi32(n, _mm256_and_si256(m, _mm256_set1_epi32(s)));
+    CLZ_STEP(16) CLZ_STEP(8) CLZ_STEP(4) CLZ_STEP(2) CLZ_STEP(1)
+#undef CLZ_STEP
+
+    *xn = x;
+    return n;
+}
+
+static inline __m256i uf8_encode8(__m256i v)
+{
+    const __m256i f = _mm256_set1_epi32(0x0F);
+    __m256i t  = _mm256_add_epi32(_mm256_srli_epi32(v, 4), _mm256_set1_epi32(1));
+    __m256i lo = _mm256_cmpeq_epi32(_mm256_srli_epi32(t, 16), _mm256_setzero_si256());
+
+    __m256i un, n = clz_norm(_mm256_add_epi32(v, _mm256_set1_epi32(16)), &un);
+    __m256i e_lo = _mm256_sub_epi32(_mm256_set1_epi32(27), n);
+    __m256i m_lo = _mm256_and_si256(_mm256_srli_epi32(un, 27), f);
+    __m256i m_hi = _mm256_and_si256(
+        _mm256_srli_epi32(_mm256_sub_epi32(v, _mm256_set1_epi32(RVC_UF8_E15_OFFSET)), 15), f);
+
+    __m256i e = _mm256_blendv_epi8(_mm256_set1_epi32(15), e_lo, lo);
+    __m256i m = _mm256_blendv_epi8(m_hi, m_lo, lo);
+    return _mm256_or_si256(_mm256_slli_epi32(e, 4), m);
+}
+
+static void uf8_encode_avx2(uint8_t *dst, const uint32_t *src, size_t n)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i c = uf8_encode8(_mm256_loadu_si256((const __m256i *)(src + i)));
+        __m128i w = _mm_packus_epi32(_mm256_castsi256_si128(c),
+                                     _mm256_extracti128_si256(c, 1));
+        _mm_storel_epi64((__m128i *)(dst + i), _mm_packus_epi16(w, w));
+    }
+    for (; i < n; i++) dst[i] = rvc_uf8_encode_ref(src[i]);
+}
+
+/* AVX2 has per-lane shifts, so decode is ((m + 16) << e) - 16 directly */
+static void uf8_decode_avx2(uint32_t *dst, const uint8_t *src, size_t n)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i c = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(src + i)));
+        __m256i m = _mm256_add_epi32(_mm256_and_si256(c, _mm256_set1_epi32(0x0F)),
+                                     _mm256_set1_epi32(16));
+        __m256i e = _mm256_srli_epi32(c, 4);
+        _mm256_storeu_si256((__m256i *)(dst + i),
+                            _mm256_sub_epi32(_mm256_sllv_epi32(m, e), _mm256_set1_epi32(16)));
+    }
+    for (; i < n; i++) dst[i] = rvc_uf8_decode_ref(src[i]);
+}
+
+static inline __m256i rsqrt8(__m256i x)
+{
+    const __m256i lo16 = _mm256_set1_epi32(0xFFFF);
+    __m256i xn, n = clz_norm(x, &xn);
+
+    __m256i y0 = _mm256_i32gather_epi32((const int *)rvc_rsqrt_y0, n, 4);
+    __m256i y1 = _mm256_i32gather_epi32((const int *)rvc_rsqrt_y1, n, 4);
+
+    /* frac = ((x - 2^e) << 16) >> e == bits 30..15 of the normalized x */
+    __m256i frac = _mm256_and_si256(_mm256_srli_epi32(xn, 15), lo16);
+    __m256i dy   = _mm256_sub_epi32(y0, y1);
+    __m256i y    = _mm256_sub_epi32(y0,
+                                    _mm256_srli_epi32(_mm256_mullo_epi32(dy, frac), 16));
+    y = _mm256_and_si256(y, lo16);
+
+    /* Newton: (x * y^2) >> 16 from 16x16 partial products */
+    __m256i y2    = _mm256_mullo_epi32(y, y);
+    __m256i y2_lo = _mm256_and_si256(y2, lo16);
+    __m256i y2_hi = _mm256_srli_epi32(y2, 16);
+    __m256i x_lo  = _mm256_and_si256(x, lo16);
+    __m256i x_hi  = _mm256_srli_epi32(x, 16);
+    __m256i acc = _mm256_slli_epi32(_mm256_mullo_epi32(x_hi, y2_hi), 16);
+    acc = _mm256_add_epi32(acc, _mm256_mullo_epi32(x_lo, y2_hi));
+    acc = _mm256_add_epi32(acc, _mm256_mullo_epi32(x_hi, y2_lo));
+    acc = _mm256_add_epi32(acc, _mm256_srli_epi32(_mm256_mullo_epi32(x_lo, y2_lo), 16));
+
+    __m256i term    = _mm256_sub_epi32(_mm256_set1_epi32(3 << 16), acc);
+    __m256i term_hi = _mm256_srli_epi32(term, 16);
+    __m256i term_lo = _mm256_and_si256(term, lo16);
+
+    /* y * term_hi for term_hi in {1,2,3}, 0 otherwise (as the guest's ternary) */
+    __m256i y2x = _mm256_slli_epi32(y, 1);
+    __m256i hi  = _mm256_and_si256(_mm256_cmpeq_epi32(term_hi, _mm256_set1_epi32(3)),
+                                   _mm256_add_epi32(y2x, y));
+    hi = _mm256_or_si256(hi, _mm256_and_si256(
+        _mm256_cmpeq_epi32(term_hi, _mm256_set1_epi32(2)), y2x));
+    hi = _mm256_or_si256(hi, _mm256_and_si256(
+        _mm256_cmpeq_epi32(term_hi, _mm256_set1_epi32(1)), y));
+
+    __m256i r = _mm256_add_epi32(_mm256_srli_epi32(hi, 1),
+                                 _mm256_srli_epi32(_mm256_mullo_epi32(y, term_lo), 17));
+    return _mm256_andnot_si256(_mm256_cmpeq_epi32(x, _mm256_setzero_si256()), r);
+}
+
+static void rsqrt_q16_avx2(uint32_t *dst, const uint32_t *src, size_t n)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm256_storeu_si256((__m256i *)(dst + i),
+                            rsqrt8(_mm256_loadu_si256((const __m256i *)(src + i))));
+    for (; i < n; i++) dst[i] = rvc_rsqrt_q16_ref(src[i]);
+}
+
+const rvc_impl rvc_impl_avx2 = {
+    "avx2", uf8_encode_avx2, uf8_decode_avx2, rsqrt_q16_avx2
+};
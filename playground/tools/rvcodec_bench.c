@@ -0,0 +1,186 @@
+/* rvcodec_bench: check every built-in rvcodec implementation against the
+ * scalar guest references, then measure batch throughput.
+ *
+ *   rvcodec_bench [--full] [--impl=NAME]
+ *
+ * The default run is sampled: all 256 uf8 codes, every 32-bit input below
+ * 2^24, +-64 around every power of two and 2^22 pseudo-random inputs.
+ * --full checks the whole 32-bit domain instead (minutes with the scalar
+ * references); `make rvcodec-check` runs it.
+ */
+#define _POSIX_C_SOURCE 199309L
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "rvcodec.h"
+
+#define CHUNK      (1u << 16)
+#define BENCH_N    (1u << 20)
+#define BENCH_REPS 16
+
+static const char *const impl_names[] = {"avx2", "sse4.1", "neon", "scalar"};
+
+static uint32_t in32[CHUNK], out32[CHUNK];
+static uint8_t  in8[CHUNK], out8[CHUNK];
+static unsigned long mismatches;
+
+static uint32_t xorshift32(uint32_t *s)
+{
+    *s ^= *s << 13;
+    *s ^= *s >> 17;
+    *s ^= *s << 5;
+    return *s;
+}
+
+static void report(const char *fn, uint32_t in, uint32_t got, uint32_t exp)
+{
+    if (mismatches++ < 8)
+        printf("    %s(0x%08x): got 0x%08x, expected 0x%08x\n", fn, in, got, exp);
+}
+
+/* Batch-process in32[0..n) and compare against the references */
+static void check_chunk(size_t n)
+{
+    rvc_uf8_encode(out8, in32, n);
+    for (size_t i = 0; i < n; i++) {
+        uint8_t exp = rvc_uf8_encode_ref(in32[i]);
+        if (out8[i] != exp) report("uf8_encode", in32[i], out8[i], exp);
+    }
+    rvc_rsqrt_q16(out32, in32, n);
+    for (size_t i = 0; i < n; i++) {
+        uint32_t exp = rvc_rsqrt_q16_ref(in32[i]);
+        if (out32[i] != exp) report("rsqrt_q16", in32[i], out32[i], exp);
+    }
+}
+
+static void check_range(uint64_t lo, uint64_t hi)
+{
+    while (lo < hi) {
+        size_t n = (hi - lo < CHUNK) ? (size_t)(hi - lo) : CHUNK;
+        for (size_t i = 0; i < n; i++) in32[i] = (uint32_t)(lo + i);
+        check_chunk(n);
+        lo += n;
+    }
+}
+
+static bool verify(bool full)
+{
+    mismatches = 0;
+
+    /* every uf8 code, and every batch length up to 17 for the tail paths;
+     * nothing past out32[len] may be written */
+    static const size_t decode_lens[] = {
+        0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 256
+    };
+    for (unsigned c = 0; c < 256; c++) in8[c] = (uint8_t)c;
+    for (size_t k = 0; k < sizeof(decode_lens) / sizeof(decode_lens[0]); k++) {
+        size_t len = decode_lens[k];
+        memset(out32, 0xA5, sizeof(out32[0]) * 257);
+        rvc_uf8_decode(out32, in8, len);
+        for (size_t c = 0; c < len; c++) {
+            uint32_t exp = rvc_uf8_decode_ref((uint8_t)c);
+            if (out32[c] != exp) report("uf8_decode", (uint32_t)c, out32[c], exp);
+        }
+        for (size_t c = len; c < 257; c++)
+            if (out32[c] != 0xA5A5A5A5u)
+                report("uf8_decode overrun", (uint32_t)len, out32[c], 0xA5A5A5A5u);
+    }
+    for (size_t len = 0; len <= 17; len++) {
+        for (size_t i = 0; i < len; i++) in32[i] = 0xFFFFFFF0u + (uint32_t)i;
+        check_chunk(len);
+    }
+
+    if (full) {
+        check_range(0, 1ull << 32);
+    } else {
+        check_range(0, 1u << 24);
+        size_t n = 0;
+        for (unsigned k = 0; k < 32; k++)
+            for (int d = -64; d <= 64; d++) in32[n++] = (uint32_t)((1ull << k) + d);
+        check_chunk(n);
+        uint32_t s = 0x12345678u;
+        for (unsigned r = 0; r < (1u << 22) / CHUNK; r++) {
+            for (size_t i = 0; i < CHUNK; i++) in32[i] = xorshift32(&s);
+            check_chunk(CHUNK);
+        }
+    }
+    return mismatches == 0;
+}
+
+static double now_sec(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double)t.tv_sec + (double)t.tv_nsec * 1e-9;
+}
+
+static void bench(void)
+{
+    static uint32_t src[BENCH_N], dst[BENCH_N];
+    static uint8_t  codes[BENCH_N];
+    uint32_t s = 0xC0FFEEu;
+    for (size_t i = 0; i < BENCH_N; i++) {
+        src[i]   = xorshift32(&s) >> (s & 15);
+        codes[i] = (uint8_t)s;
+    }
+
+    double t0 = now_sec();
+    for (int r = 0; r < BENCH_REPS; r++) rvc_uf8_encode(codes, src, BENCH_N);
+    double t1 = now_sec();
+    for (int r = 0; r < BENCH_REPS; r++) rvc_uf8_decode(dst, codes, BENCH_N);
+    double t2 = now_sec();
+    for (int r = 0; r < BENCH_REPS; r++) rvc_rsqrt_q16(dst, src, BENCH_N);
+    double t3 = now_sec();
+
+    double msamples = (double)BENCH_N * BENCH_REPS / 1e6;
+    printf("  uf8_encode %8.1f Msamples/s\n", msamples / (t1 - t0));
+    printf("  uf8_decode %8.1f Msamples/s\n", msamples / (t2 - t1));
+    printf("  rsqrt_q16  %8.1f Msamples/s\n", msamples / (t3 - t2));
+}
+
+int main(int argc, char **argv)
+{
+    bool full = false;
+    const char *only = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--full") == 0) {
+            full = true;
+        } else if (strncmp(argv[i], "--impl=", 7) == 0) {
+            only = argv[i] + 7;
+        } else {
+            fprintf(stderr,
+                    "usage: %s [--full] [--impl=avx2|sse4.1|neon|scalar]\n"
+                    "  default: sampled inputs (< 2^24, +-64 around powers of two, 2^22 random)\n"
+                    "  --full:  every 32-bit input\n", argv[0]);
+            return 2;
+        }
+    }
+
+    int failed = 0, ran = 0;
+    for (size_t k = 0; k < sizeof(impl_names) / sizeof(impl_names[0]); k++) {
+        if (only && strcmp(only, impl_names[k]) != 0) continue;
+        if (!rvc_select_impl(impl_names[k])) continue;
+        ran++;
+
+        printf("=== %s ===\n", rvc_impl_name());
+        const char *cover = full ? "exhaustive" : "sampled";
+        if (verify(full)) {
+            printf("  bit-exact vs guest reference (%s): PASSED\n", cover);
+        } else {
+            printf("  bit-exact vs guest reference (%s): FAILED (%lu mismatches)\n",
+                   cover, mismatches);
+            failed++;
+        }
+        bench();
+    }
+    if (!ran) {
+        fprintf(stderr, "no matching implementation available\n");
+        return 2;
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,30 @@
+#ifndef RVCODEC_IMPL_H
+#define RVCODEC_IMPL_H
+
+/* Shared between rvcodec.c and the per-ISA translation units */
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct {
+    const char *name;
+    void (*uf8_encode)(uint8_t *dst, const uint32_t *src, size_t n);
+    void (*uf8_decode)(uint32_t *dst, const uint8_t *src, size_t n);
+    void (*rsqrt_q16)(uint32_t *dst, const uint32_t *src, size_t n);
+} rvc_impl;
+
+/* fast_rsqrt's LUT indexed by clz(x) instead of the exponent:
+ * rvc_rsqrt_y0[n] = rsqrt_table[31 - n], rvc_rsqrt_y1[n] = rsqrt_table[32 - n]
+ * (1 past the end, as in fast_rsqrt). Entry 32 covers clz(0). Filled from
+ * the guest table by rvcodec.c before any batch function runs. */
+extern uint32_t rvc_rsqrt_y0[33];
+extern uint32_t rvc_rsqrt_y1[33];
+
+/* Start of the exponent-15 uf8 range; larger values all encode with e = 15 */
+#define RVC_UF8_E15_OFFSET 0x7FFF0u    /* ((1 << 15) - 1) << 4 */
+
+extern const rvc_impl rvc_impl_sse41;
+extern const rvc_impl rvc_impl_avx2;
+extern const rvc_impl rvc_impl_neon;
+
+#endif /* RVCODEC_IMPL_H */
@@ -0,0 +1,105 @@
+/* NEON batch codecs (AArch64). Same closed forms as rvcodec_sse41.c, using
+ * vclz and per-lane vshl instead of the constant-shift normalization. */
+#include <arm_neon.h>
+
+#include "rvcodec.h"
+#include "rvcodec_impl.h"
+
+static inline uint32x4_t uf8_encode4(uint32x4_t v)
+{
+    const uint32x4_t f = vdupq_n_u32(0x0F);
+    uint32x4_t t  = vaddq_u32(vshrq_n_u32(v, 4), vdupq_n_u32(1));
+    uint32x4_t lo = vceqq_u32(vshrq_n_u32(t, 16), vdupq_n_u32(0));
+
+    uint32x4_t u    = vaddq_u32(v, vdupq_n_u32(16));
+    uint32x4_t n    = vclzq_u32(u);
+    uint32x4_t un   = vshlq_u32(u, vreinterpretq_s32_u32(n));
+    uint32x4_t e_lo = vsubq_u32(vdupq_n_u32(27), n);
+    uint32x4_t m_lo = vandq_u32(vshrq_n_u32(un, 27), f);
+    uint32x4_t m_hi = vandq_u32(
+        vshrq_n_u32(vsubq_u32(v, vdupq_n_u32(RVC_UF8_E15_OFFSET)), 15), f);
+
+    uint32x4_t e = vbslq_u32(lo, e_lo, vdupq_n_u32(15));
+    uint32x4_t m = vbslq_u32(lo, m_lo, m_hi);
+    return vorrq_u32(vshlq_n_u32(e, 4), m);
+}
+
+static void uf8_encode_neon(uint8_t *dst, const uint32_t *src, size_t n)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        uint16x4_t a = vmovn_u32(uf8_encode4(vld1q_u32(src + i)));
+        uint16x4_t b = vmovn_u32(uf8_encode4(vld1q_u32(src + i + 4)));
+        vst1_u8(dst + i, vmovn_u16(vcombine_u16(a, b)));
+    }
+    for (; i < n; i++) dst[i] = rvc_uf8_encode_ref(src[i]);
+}
+
+static void uf8_decode_neon(uint32_t *dst, const uint8_t *src, size_t n)
+{
+    const uint32x4_t f = vdupq_n_u32(0x0F), k16 = vdupq_n_u32(16);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        uint16x8_t c16 = vmovl_u8(vld1_u8(src + i));
+        uint32x4_t c[2] = { vmovl_u16(vget_low_u16(c16)), vmovl_u16(vget_high_u16(c16)) };
+        for (int h = 0; h < 2; h++) {
+            uint32x4_t m = vaddq_u32(vandq_u32(c[h], f), k16);
+            int32x4_t  e = vreinterpretq_s32_u32(vshrq_n_u32(c[h], 4));
+            vst1q_u32(dst + i + 4 * h, vsubq_u32(vshlq_u32(m, e), k16));
+        }
+    }
+    for (; i < n; i++) dst[i] = rvc_uf8_decode_ref(src[i]);
+}
+
+static inline uint32x4_t rsqrt4(uint32x4_t x)
+{
+    const uint32x4_t lo16 = vdupq_n_u32(0xFFFF);
+    uint32x4_t n  = vclzq_u32(x);                       /* 32 for x == 0 */
+    uint32x4_t xn = vshlq_u32(x, vreinterpretq_s32_u32(n));
+
+    uint32_t idx[4], t0[4], t1[4];
+    vst1q_u32(idx, n);
+    for (int k = 0; k < 4; k++) {
+        t0[k] = rvc_rsqrt_y0[idx[k]];
+        t1[k] = rvc_rsqrt_y1[idx[k]];
+    }
+    uint32x4_t y0 = vld1q_u32(t0);
+    uint32x4_t y1 = vld1q_u32(t1);
+
+    uint32x4_t frac = vandq_u32(vshrq_n_u32(xn, 15), lo16);
+    uint32x4_t y    = vsubq_u32(y0, vshrq_n_u32(vmulq_u32(vsubq_u32(y0, y1), frac), 16));
+    y = vandq_u32(y, lo16);
+
+    uint32x4_t y2    = vmulq_u32(y, y);
+    uint32x4_t y2_lo = vandq_u32(y2, lo16);
+    uint32x4_t y2_hi = vshrq_n_u32(y2, 16);
+    uint32x4_t x_lo  = vandq_u32(x, lo16);
+    uint32x4_t x_hi  = vshrq_n_u32(x, 16);
+    uint32x4_t acc = vshlq_n_u32(vmulq_u32(x_hi, y2_hi), 16);
+    acc = vmlaq_u32(acc, x_lo, y2_hi);
+    acc = vmlaq_u32(acc, x_hi, y2_lo);
+    acc = vaddq_u32(acc, vshrq_n_u32(vmulq_u32(x_lo, y2_lo), 16));
+
+    uint32x4_t term    = vsubq_u32(vdupq_n_u32(3u << 16), acc);
+    uint32x4_t term_hi = vshrq_n_u32(term, 16);
+    uint32x4_t term_lo = vandq_u32(term, lo16);
+
+    uint32x4_t y2x = vshlq_n_u32(y, 1);
+    uint32x4_t hi  = vandq_u32(vceqq_u32(term_hi, vdupq_n_u32(3)), vaddq_u32(y2x, y));
+    hi = vorrq_u32(hi, vandq_u32(vceqq_u32(term_hi, vdupq_n_u32(2)), y2x));
+    hi = vorrq_u32(hi, vandq_u32(vceqq_u32(term_hi, vdupq_n_u32(1)), y));
+
+    uint32x4_t r = vaddq_u32(vshrq_n_u32(hi, 1), vshrq_n_u32(vmulq_u32(y, term_lo), 17));
+    return vbicq_u32(r, vceqq_u32(x, vdupq_n_u32(0)));
+}
+
+static void rsqrt_q16_neon(uint32_t *dst, const uint32_t *src, size_t n)
+{
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) vst1q_u32(dst + i, rsqrt4(vld1q_u32(src + i)));
+    for (; i < n; i++) dst[i] = rvc_rsqrt_q16_ref(src[i]);
+}
+
+const rvc_impl rvc_impl_neon = {
+    "neon", uf8_encode_neon, uf8_decode_neon, rsqrt_q16_neon
+};
@@ -0,0 +1,137 @@
+/* SSE4.1 batch codecs; build with -msse4.1, called only after dispatch */
+#include <smmintrin.h>
+#include <string.h>
+
+#include "rvcodec.h"
+#include "rvcodec_impl.h"
+
+/* Count leading zeros and left-normalize with constant shifts only
+ * (SSE has no per-lane variable shift). clz(0) comes out as 31. */
+static inline __m128i clz_norm(__m128i x, __m128i *xn)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i n = zero, m;
+
+#define CLZ_STEP(s)                                                  \
+    m = _mm_cmpeq_epi32(_mm_srli_epi32(x, 32 - (s)), zero);          \
+    x = _mm_blendv_epi8(x, _mm_slli_epi32(x, (s)), m);               \
+    n = _mm_add_epi32(n, _mm_and_si128(m, _mm_set1_epi32(s)));
+    CLZ_STEP(16) CLZ_STEP(8) CLZ_STEP(4) CLZ_STEP(2) CLZ_STEP(1)
+#undef CLZ_STEP
+
+    *xn = x;
+    return n;
+}
+
+/* uf8_encode closed form:
+ *   e = min(15, msb((v >> 4) + 1)), m = ((v + 16) >> e) & 15
+ * For e < 15, v + 16 has its msb at e + 4, so m is the 4 bits under the msb
+ * of the normalized v + 16. The e = 15 range uses a constant shift. */
+static inline __m128i uf8_encode4(__m128i v)
+{
+    const __m128i f = _mm_set1_epi32(0x0F);
+    __m128i t  = _mm_add_epi32(_mm_srli_epi32(v, 4), _mm_set1_epi32(1));
+    __m128i lo = _mm_cmpeq_epi32(_mm_srli_epi32(t, 16), _mm_setzero_si128());
+
+    __m128i un, n = clz_norm(_mm_add_epi32(v, _mm_set1_epi32(16)), &un);
+    __m128i e_lo = _mm_sub_epi32(_mm_set1_epi32(27), n);
+    __m128i m_lo = _mm_and_si128(_mm_srli_epi32(un, 27), f);
+    __m128i m_hi = _mm_and_si128(
+        _mm_srli_epi32(_mm_sub_epi32(v, _mm_set1_epi32(RVC_UF8_E15_OFFSET)), 15), f);
+
+    __m128i e = _mm_blendv_epi8(_mm_set1_epi32(15), e_lo, lo);
+    __m128i m = _mm_blendv_epi8(m_hi, m_lo, lo);
+    return _mm_or_si128(_mm_slli_epi32(e, 4), m);
+}
+
+static void uf8_encode_sse41(uint8_t *dst, const uint32_t *src, size_t n)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i a = uf8_encode4(_mm_loadu_si128((const __m128i *)(src + i)));
+        __m128i b = uf8_encode4(_mm_loadu_si128((const __m128i *)(src + i + 4)));
+        __m128i w = _mm_packus_epi32(a, b);
+        _mm_storel_epi64((__m128i *)(dst + i), _mm_packus_epi16(w, w));
+    }
+    for (; i < n; i++) dst[i] = rvc_uf8_encode_ref(src[i]);
+}
+
+/* ((m + 16) << e) - 16; 2^e is built as a float and converted exactly */
+static void uf8_decode_sse41(uint32_t *dst, const uint8_t *src, size_t n)
+{
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        int32_t word;
+        memcpy(&word, src + i, 4);
+        __m128i c = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(word));
+        __m128i m = _mm_add_epi32(_mm_and_si128(c, _mm_set1_epi32(0x0F)),
+                                  _mm_set1_epi32(16));
+        __m128i e = _mm_srli_epi32(c, 4);
+        __m128i p = _mm_cvttps_epi32(_mm_castsi128_ps(
+            _mm_slli_epi32(_mm_add_epi32(e, _mm_set1_epi32(127)), 23)));
+        __m128i r = _mm_sub_epi32(_mm_mullo_epi32(m, p), _mm_set1_epi32(16));
+        _mm_storeu_si128((__m128i *)(dst + i), r);
+    }
+    for (; i < n; i++) dst[i] = rvc_uf8_decode_ref(src[i]);
+}
+
+/* fast_rsqrt on four lanes; every 16x16 product fits a 32-bit lane, and the
+ * guest truncates its 64-bit Newton accumulator to 32 bits, so wrapping
+ * 32-bit adds give the same result. */
+static inline __m128i rsqrt4(__m128i x)
+{
+    const __m128i lo16 = _mm_set1_epi32(0xFFFF);
+    __m128i xn, n = clz_norm(x, &xn);
+
+    uint32_t idx[4];
+    _mm_storeu_si128((__m128i *)idx, n);
+    __m128i y0 = _mm_setr_epi32((int)rvc_rsqrt_y0[idx[0]], (int)rvc_rsqrt_y0[idx[1]],
+                                (int)rvc_rsqrt_y0[idx[2]], (int)rvc_rsqrt_y0[idx[3]]);
+    __m128i y1 = _mm_setr_epi32((int)rvc_rsqrt_y1[idx[0]], (int)rvc_rsqrt_y1[idx[1]],
+                                (int)rvc_rsqrt_y1[idx[2]], (int)rvc_rsqrt_y1[idx[3]]);
+
+    /* frac = ((x - 2^e) << 16) >> e == bits 30..15 of the normalized x */
+    __m128i frac = _mm_and_si128(_mm_srli_epi32(xn, 15), lo16);
+    __m128i dy   = _mm_sub_epi32(y0, y1);
+    __m128i y    = _mm_sub_epi32(y0, _mm_srli_epi32(_mm_mullo_epi32(dy, frac), 16));
+    y = _mm_and_si128(y, lo16);
+
+    /* Newton: (x * y^2) >> 16 from 16x16 partial products */
+    __m128i y2    = _mm_mullo_epi32(y, y);
+    __m128i y2_lo = _mm_and_si128(y2, lo16);
+    __m128i y2_hi = _mm_srli_epi32(y2, 16);
+    __m128i x_lo  = _mm_and_si128(x, lo16);
+    __m128i x_hi  = _mm_srli_epi32(x, 16);
+    __m128i acc = _mm_slli_epi32(_mm_mullo_epi32(x_hi, y2_hi), 16);
+    acc = _mm_add_epi32(acc, _mm_mullo_epi32(x_lo, y2_hi));
+    acc = _mm_add_epi32(acc, _mm_mullo_epi32(x_hi, y2_lo));
+    acc = _mm_add_epi32(acc, _mm_srli_epi32(_mm_mullo_epi32(x_lo, y2_lo), 16));
+
+    __m128i term    = _mm_sub_epi32(_mm_set1_epi32(3 << 16), acc);
+    __m128i term_hi = _mm_srli_epi32(term, 16);
+    __m128i term_lo = _mm_and_si128(term, lo16);
+
+    /* y * term_hi for term_hi in {1,2,3}, 0 otherwise (as the guest's ternary) */
+    __m128i y2x = _mm_slli_epi32(y, 1);
+    __m128i hi  = _mm_and_si128(_mm_cmpeq_epi32(term_hi, _mm_set1_epi32(3)),
+                                _mm_add_epi32(y2x, y));
+    hi = _mm_or_si128(hi, _mm_and_si128(_mm_cmpeq_epi32(term_hi, _mm_set1_epi32(2)), y2x));
+    hi = _mm_or_si128(hi, _mm_and_si128(_mm_cmpeq_epi32(term_hi, _mm_set1_epi32(1)), y));
+
+    __m128i r = _mm_add_epi32(_mm_srli_epi32(hi, 1),
+                              _mm_srli_epi32(_mm_mullo_epi32(y, term_lo), 17));
+    return _mm_andnot_si128(_mm_cmpeq_epi32(x, _mm_setzero_si128()), r);
+}
+
+static void rsqrt_q16_sse41(uint32_t *dst, const uint32_t *src, size_t n)
+{
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm_storeu_si128((__m128i *)(dst + i),
+                         rsqrt4(_mm_loadu_si128((const __m128i *)(src + i))));
+    for (; i < n; i++) dst[i] = rvc_rsqrt_q16_ref(src[i]);
+}
+
+const rvc_impl rvc_impl_sse41 = {
+    "sse4.1", uf8_encode_sse41, uf8_decode_sse41, rsqrt_q16_sse41
+};
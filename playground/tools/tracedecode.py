@@ -0,0 +1,133 @@
+#!/usr/bin/env python3
+"""Render the binary event trace written by tracelog.c.
+
+    tools/tracedecode.py [--elf test.elf] [TRACE]
+
+TRACE holds what test.elf wrote to its --trace=FD descriptor (default:
+stdin). Event names and formats come from the .trace_fmt section of the
+ELF that produced it, so the guest never formats anything; decode with the
+same build. Each frame is "TRC1", a record count and that many 24-byte
+records (id, low 32 bits of the cycle counter, four args), little-endian.
+Bytes between frames, e.g. emulator messages on the same stream, are
+skipped and counted.
+
+One line per record: absolute cycle (timestamps unwrapped across 2^32),
+cycles since the previous record, event name and formatted text. Format
+directives: %u %d %x %c and %q (unsigned Q16, four decimals).
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+from elfobj import ElfObject
+
+MAGIC = b"TRC1"
+HDR_SIZE, REC_SIZE = 8, 24
+
+DIRECTIVE_RE = re.compile(r"%(.)")
+
+
+def load_formats(path):
+    elf = ElfObject(path)
+    if ".trace_fmt" not in elf.names:
+        sys.exit("%s: no .trace_fmt section (built without tracelog.o?)" % path)
+    sec = elf.sections[elf.names.index(".trace_fmt")]
+    data = elf.data[sec[4]:sec[4] + sec[5]]
+    events, pos = [], 0
+    while pos < len(data):
+        nargs = data[pos]
+        end = data.index(b"\0", pos + 1)
+        name = data[pos + 1:end].decode()
+        fend = data.index(b"\0", end + 1)
+        events.append((name, nargs, data[end + 1:fend].decode()))
+        pos = fend + 1
+    return events
+
+
+def render(fmt, args):
+    it = iter(args)
+
+    def directive(m):
+        c = m.group(1)
+        if c == "%":
+            return "%"
+        v = next(it, 0)
+        if c == "u":
+            return str(v)
+        if c == "d":
+            return str(v - (1 << 32) if v & 0x80000000 else v)
+        if c == "x":
+            return "%x" % v
+        if c == "c":
+            return chr(v & 0xFF)
+        if c == "q":
+            return "%.4f" % (v / 65536.0)
+        return m.group(0)
+
+    return DIRECTIVE_RE.sub(directive, fmt)
+
+
+def frames(data):
+    """Yield (records, skipped bytes before the frame); the last item may
+    carry only the trailing skip."""
+    pos = 0
+    while True:
+        start = data.find(MAGIC, pos)
+        if start < 0:
+            yield [], len(data) - pos
+            return
+        end = start + HDR_SIZE
+        if end <= len(data):
+            count, = struct.unpack_from("<I", data, start + 4)
+            end += count * REC_SIZE
+        if end > len(data):
+            yield [], len(data) - pos      # truncated frame
+            return
+        recs = [struct.unpack_from("<6I", data, start + HDR_SIZE + i * REC_SIZE)
+                for i in range(count)]
+        yield recs, start - pos
+        pos = end
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    ap.add_argument("--elf", default="test.elf")
+    ap.add_argument("trace", nargs="?", help="trace file (default: stdin)")
+    args = ap.parse_args()
+
+    events = load_formats(args.elf)
+    if args.trace:
+        with open(args.trace, "rb") as f:
+            data = f.read()
+    else:
+        data = sys.stdin.buffer.read()
+
+    nframes = nrecs = skipped = 0
+    base = prev = None
+    hi = 0
+    for recs, skip in frames(data):
+        skipped += skip
+        nframes += 1 if recs else 0
+        for rid, ts, a0, a1, a2, a3 in recs:
+            if prev is not None and ts < (prev & 0xFFFFFFFF):
+                hi += 1 << 32
+            now = hi + ts
+            if base is None:
+                base = prev = now
+            if rid < len(events):
+                name, nargs, fmt = events[rid]
+                text = render(fmt, (a0, a1, a2, a3)[:nargs])
+            else:
+                name, text = "?%d" % rid, "%x %x %x %x" % (a0, a1, a2, a3)
+            print("%12d %+10d  %-12s %s" % (now - base, now - prev, name, text))
+            prev = now
+            nrecs += 1
+
+    print("%d records in %d frames, %d bytes skipped" % (nrecs, nframes, skipped),
+          file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,82 @@
+#include <stdint.h>
+
+#include "tracelog.h"
+
+extern uint64_t get_cycles(void);
+
+/* ---------------- Format table ----------------
+ * Per event, in id order: .byte nargs, .asciz name, .asciz format.
+ * The section has no "a" flag, so the linker keeps it out of the image. */
+#define TRACE_STR_(x) #x
+#define TRACE_STR(x)  TRACE_STR_(x)
+#define TRACE_FMT(name, nargs, fmt)                     \
+    ".byte " TRACE_STR(nargs) "\n"                      \
+    ".asciz \"" #name "\"\n"                            \
+    ".asciz \"" fmt "\"\n"
+
+__asm__(".pushsection .trace_fmt,\"\",@progbits\n"
+        TRACE_EVENTS(TRACE_FMT)
+        ".popsection\n");
+
+/* ---------------- Record buffer ---------------- */
+#define TRACE_REC_WORDS (TRACE_REC_SIZE / 4u)
+
+_Static_assert(TRACE_CAPACITY > 0u, "TRACE_CAPACITY must be positive");
+
+/* header words, then TRACE_CAPACITY records */
+static uint32_t trace_buf[TRACE_HDR_SIZE / 4u + TRACE_CAPACITY * TRACE_REC_WORDS];
+static uint32_t *trace_next = trace_buf + TRACE_HDR_SIZE / 4u;
+static uint32_t trace_count;
+static int      trace_fd = -1;
+static trace_stats trace_st;
+
+void trace_init(int fd)
+{
+    trace_fd    = fd;
+    trace_next  = trace_buf + TRACE_HDR_SIZE / 4u;
+    trace_count = 0;
+    trace_st.records = 0;
+    trace_st.flushes = 0;
+    trace_st.bytes   = 0;
+}
+
+void trace_flush(void)
+{
+    if (trace_count == 0) return;
+
+    uint32_t len = TRACE_HDR_SIZE + trace_count * TRACE_REC_SIZE;
+    trace_buf[0] = TRACE_MAGIC;
+    trace_buf[1] = trace_count;
+    if (trace_fd >= 0) {
+        register long a0 asm("a0") = trace_fd;
+        register long a1 asm("a1") = (long)trace_buf;
+        register long a2 asm("a2") = (long)len;
+        register long a7 asm("a7") = 64;       /* SYS_write */
+        asm volatile("ecall" : "+r"(a0) : "r"(a1), "r"(a2), "r"(a7) : "memory");
+    }
+    trace_st.bytes += len;
+    trace_st.flushes++;
+    trace_next  = trace_buf + TRACE_HDR_SIZE / 4u;
+    trace_count = 0;
+}
+
+void trace_emit(uint32_t id, uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3)
+{
+    if (trace_count == TRACE_CAPACITY) trace_flush();
+
+    uint32_t *r = trace_next;
+    r[0] = id;
+    r[1] = (uint32_t)get_cycles();
+    r[2] = a0;
+    r[3] = a1;
+    r[4] = a2;
+    r[5] = a3;
+    trace_next = r + TRACE_REC_WORDS;
+    trace_count++;
+    trace_st.records++;
+}
+
+void trace_get_stats(trace_stats *st)
+{
+    *st = trace_st;
+}
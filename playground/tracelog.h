@@ -0,0 +1,61 @@
+#ifndef TRACELOG_H
+#define TRACELOG_H
+
+#include <stdint.h>
+
+/* ---------------- Binary event trace ----------------
+ * TRACEn(EVENT, args...) appends one fixed-size record to a static buffer:
+ * no formatting, no syscall. A full buffer, or trace_flush(), writes every
+ * pending record as one frame with a single SYS_write:
+ *   [0..3]  'T','R','C','1'  magic
+ *   [4..7]  record count     (little-endian, as every field below)
+ *   [8..]   records, 24 bytes each: id, low 32 bits of get_cycles(), arg[4]
+ * Unused args are 0. The decoder unwraps the 32-bit timestamps, so two
+ * consecutive records must be less than 2^32 cycles apart.
+ *
+ * The event table lives in TRACE_EVENTS(X): X(NAME, nargs, "format").
+ * tracelog.c copies it into the non-allocated .trace_fmt section of the
+ * ELF, where tools/tracedecode.py reads it back; the formats take no target
+ * memory. Formats understand %u %d %x %c and %q (unsigned Q16), and must
+ * not contain '"' or '\'. Events are numbered in list order; only append.
+ */
+#define TRACE_EVENTS(X)                                            \
+    X(MARK,       1, "mark %u")                                    \
+    X(HANOI_MOVE, 3, "move disk %u from %c to %c")                 \
+    X(COST,       3, "%u events: text %u cycles, trace %u cycles") \
+    X(UF8_DATA,   1, "Data: %u")                                   \
+    X(RSQRT,      2, "x=%u  fast_rsqrt≈%q")
+
+#define TRACE_ENUM(name, nargs, fmt) TRACE_##name,
+enum { TRACE_EVENTS(TRACE_ENUM) TRACE_NUM_EVENTS };
+#undef TRACE_ENUM
+
+#ifndef TRACE_CAPACITY
+#define TRACE_CAPACITY 128u     /* records per frame; 3 KB of buffer */
+#endif
+
+#define TRACE_MAGIC      0x31435254u   /* "TRC1" */
+#define TRACE_HDR_SIZE   8u
+#define TRACE_REC_SIZE   24u
+
+typedef struct {
+    uint32_t records;
+    uint32_t flushes;
+    uint32_t bytes;         /* frame bytes, written or not */
+} trace_stats;
+
+/* Frames go to fd via SYS_write, or are only counted when fd < 0 (keeps
+ * binary output off the console). Drops pending records and zeroes the
+ * stats. */
+void trace_init(int fd);
+void trace_emit(uint32_t id, uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3);
+void trace_flush(void);
+void trace_get_stats(trace_stats *st);
+
+#define TRACE0(ev)                 trace_emit(TRACE_##ev, 0, 0, 0, 0)
+#define TRACE1(ev, a)              trace_emit(TRACE_##ev, (a), 0, 0, 0)
+#define TRACE2(ev, a, b)           trace_emit(TRACE_##ev, (a), (b), 0, 0)
+#define TRACE3(ev, a, b, c)        trace_emit(TRACE_##ev, (a), (b), (c), 0)
+#define TRACE4(ev, a, b, c, d)     trace_emit(TRACE_##ev, (a), (b), (c), (d))
+
+#endif /* TRACELOG_H */
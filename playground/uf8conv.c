@@ -0,0 +1,146 @@
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common.h"
+#include "uf8conv.h"
+
+#define F32_BIAS   127u
+#define F32_HIDDEN 0x00800000u
+
+/* Index of the highest set bit, x != 0 (binary search, no Zbb) */
+static inline uint32_t msb32(uint32_t x)
+{
+    uint32_t n = 0;
+    if (x >> 16) { n += 16; x >>= 16; }
+    if (x >> 8)  { n += 8;  x >>= 8;  }
+    if (x >> 4)  { n += 4;  x >>= 4;  }
+    if (x >> 2)  { n += 2;  x >>= 2;  }
+    return n + (x >> 1);
+}
+
+/* v <= UF8_MAX: v + 16 = (16 + m) << e with msb(v + 16) = e + 4 */
+static inline uint8_t encode_msb(uint32_t v, uint32_t msb_t)
+{
+    uint32_t e = msb_t - 4u;
+    return (uint8_t)((e << 4) | (((v + 16u) >> e) & 0x0Fu));
+}
+
+static inline uint8_t encode_sat(uint32_t v)
+{
+    if (v > UF8_MAX) return 0xFFu;
+    return encode_msb(v, msb32(v + 16u));
+}
+
+/* ---------------- uf8 <-> Q16 ---------------- */
+bool uf8_to_q16(uint32_t *dst, const uint8_t *src, uint32_t n, uint32_t scale)
+{
+    if (scale < UF8CONV_SCALE_MIN || scale > UF8CONV_SCALE_MAX) return false;
+    if (scale <= 16u) {
+        /* v << s == ((m + 16) << (e + s)) - (16 << s): one shift per code */
+        uint32_t s = 16u - scale, off = 16u << s;
+        for (uint32_t i = 0; i < n; i++) {
+            uint32_t c = src[i];
+            dst[i] = (((c & 0x0Fu) + 16u) << ((c >> 4) + s)) - off;
+        }
+    } else {
+        uint32_t s = scale - 16u;
+        for (uint32_t i = 0; i < n; i++) {
+            uint32_t c = src[i];
+            dst[i] = ((((c & 0x0Fu) + 16u) << (c >> 4)) - 16u) >> s;
+        }
+    }
+    return true;
+}
+
+bool q16_to_uf8(uint8_t *dst, const uint32_t *src, uint32_t n, uint32_t scale)
+{
+    if (scale < UF8CONV_SCALE_MIN || scale > UF8CONV_SCALE_MAX) return false;
+    if (scale <= 16u) {
+        uint32_t s = 16u - scale;
+        for (uint32_t i = 0; i < n; i++)
+            dst[i] = encode_sat(src[i] >> s);
+    } else {
+        uint32_t s = scale - 16u, limit = UF8_MAX >> s;
+        for (uint32_t i = 0; i < n; i++)
+            dst[i] = (src[i] > limit) ? 0xFFu : encode_sat(src[i] << s);
+    }
+    return true;
+}
+
+/* ---------------- uf8 <-> float32 ---------------- */
+void uf8_to_f32(uint32_t *dst, const uint8_t *src, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t c = src[i], e = c >> 4;
+        uint32_t v = (((c & 0x0Fu) + 16u) << e) - 16u;
+        uint32_t msb;
+
+        if (v == 0u) { dst[i] = 0u; continue; }
+        /* e >= 1: v lies in [2^(e+3), 2^(e+5)); one compare picks the msb */
+        if (e)  msb = e + 4u - (v < (16u << e));
+        else    msb = msb32(v);
+        dst[i] = ((F32_BIAS + msb - 1u) << 23) + (v << (23u - msb));
+    }
+}
+
+void f32_to_uf8(uint8_t *dst, const uint32_t *src, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t b = src[i];
+        uint32_t be = (b >> 23) & 0xFFu;
+
+        /* negative (incl. -0), NaN, below 1.0 */
+        if ((b >> 31) || (b & 0x7FFFFFFFu) > 0x7F800000u || be < F32_BIAS) {
+            dst[i] = 0u;
+            continue;
+        }
+        uint32_t E = be - F32_BIAS;                   /* v in [2^E, 2^(E+1)) */
+        if (E >= 20u) { dst[i] = 0xFFu; continue; }   /* > UF8_MAX, incl. inf */
+
+        uint32_t v = ((b & 0x007FFFFFu) | F32_HIDDEN) >> (23u - E);
+        if (E < 4u)          dst[i] = (uint8_t)v;     /* v < 16 is its own code */
+        else if (v > UF8_MAX) dst[i] = 0xFFu;
+        else                 dst[i] = encode_msb(v, E + ((v + 16u) >> (E + 1u)));
+    }
+}
+
+/* ---------------- Q16 <-> float32 ---------------- */
+void q16_to_f32(uint32_t *dst, const uint32_t *src, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t raw = src[i];
+        if (raw == 0u) { dst[i] = 0u; continue; }
+
+        uint32_t msb = msb32(raw), mant;
+        if (msb <= 23u) {
+            mant = raw << (23u - msb);
+        } else {
+            /* round to nearest, ties to even; a carry out of the mantissa
+             * bumps the exponent through the add below */
+            uint32_t sh = msb - 23u;
+            uint32_t rem = raw & ((1u << sh) - 1u), half = 1u << (sh - 1u);
+            mant = raw >> sh;
+            if (rem > half || (rem == half && (mant & 1u))) mant++;
+        }
+        dst[i] = ((F32_BIAS + msb - 16u - 1u) << 23) + mant;
+    }
+}
+
+void f32_to_q16(uint32_t *dst, const uint32_t *src, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t b = src[i];
+        uint32_t be = (b >> 23) & 0xFFu;
+
+        if ((b >> 31) || (b & 0x7FFFFFFFu) > 0x7F800000u || be + 16u < F32_BIAS) {
+            dst[i] = 0u;                               /* also everything < 2^-16 */
+            continue;
+        }
+        if (be >= F32_BIAS + 16u) { dst[i] = 0xFFFFFFFFu; continue; }
+
+        /* raw = mant * 2^(E + 16 - 23) with E + 16 in [0, 32) */
+        uint32_t mant = (b & 0x007FFFFFu) | F32_HIDDEN;
+        uint32_t e16 = be + 16u - F32_BIAS;
+        dst[i] = (e16 >= 23u) ? mant << (e16 - 23u) : mant >> (23u - e16);
+    }
+}
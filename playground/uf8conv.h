@@ -0,0 +1,38 @@
+#ifndef UF8CONV_H
+#define UF8CONV_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* ---------------- Batch uf8 / Q16 / float32 converters ----------------
+ * A uf8 code e:m stands for ((m + 16) << e) - 16, so its binary exponent is
+ * known from e; every converter below works on exponents and shifts, with
+ * no multiply and no per-element uf8_decode/uf8_encode call.
+ *
+ * Q16 values carry a scale: raw = floor(v * 2^(16 - scale)), i.e. the Q16
+ * number is v / 2^scale. Scales 4..16 keep every uf8 value exact
+ * (uf8_decode(0xFF) < 2^20); scale = 20 maps the uf8 range into [0, 1)
+ * and drops the low 4 bits.
+ *
+ * float32 values are IEEE-754 bit patterns in uint32_t (no FPU needed).
+ *
+ * Rounding: towards the uf8 code or Q16 value below (as uf8_encode does),
+ * round-to-nearest-even into float32. Results saturate instead of wrapping:
+ * negative and NaN inputs give 0, values above uf8_decode(0xFF) give 0xFF,
+ * floats >= 65536.0 give Q16 0xFFFFFFFF.
+ */
+#define UF8CONV_SCALE_MIN 4u
+#define UF8CONV_SCALE_MAX 31u
+
+/* false, with dst untouched, if scale is outside UF8CONV_SCALE_MIN..MAX:
+ * below 4 the largest uf8 values overflow 32 bits, above 31 the shifts do */
+bool uf8_to_q16(uint32_t *dst, const uint8_t *src, uint32_t n, uint32_t scale);
+bool q16_to_uf8(uint8_t *dst, const uint32_t *src, uint32_t n, uint32_t scale);
+
+void uf8_to_f32(uint32_t *dst, const uint8_t *src, uint32_t n);
+void f32_to_uf8(uint8_t *dst, const uint32_t *src, uint32_t n);
+
+void q16_to_f32(uint32_t *dst, const uint32_t *src, uint32_t n);
+void f32_to_q16(uint32_t *dst, const uint32_t *src, uint32_t n);
+
+#endif /* UF8CONV_H */